@@ -0,0 +1,147 @@
+#include <SDL.h>
+#include <iostream>
+#include <vector>
+
+#include "Rendering/RenderQueue.h"
+#include "Rendering/SpriteBatcher.h"
+
+/**
+* Draws queues that mix sprites and solid fills at the same layer and depth through the SpriteBatcher,
+* into a software renderer, and checks every command landed with the right texture or color.
+* Needs no window or GPU. Exits with 1 if a command was drawn wrong.
+*/
+
+namespace
+{
+	constexpr int CELL_SIZE = 8;
+	constexpr int CELL_STRIDE = 10;
+	constexpr int CELL_COUNT = 9;
+
+	struct Cell
+	{
+		// The depth inside the layer, cells with the same depth can be reordered by the batcher
+		int depth;
+
+		// The sprite texture, or nullptr for a fill of the color
+		SDL_Texture* texture;
+		SDL_Color color;
+	};
+
+	SDL_Texture* createSolidTexture(SDL_Renderer* renderer, const SDL_Color& color)
+	{
+		SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, CELL_SIZE, CELL_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+		if (surface == nullptr)
+		{
+			return nullptr;
+		}
+
+		SDL_FillRect(surface, nullptr, SDL_MapRGBA(surface->format, color.r, color.g, color.b, color.a));
+		SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+		SDL_FreeSurface(surface);
+
+		return texture;
+	}
+
+	bool drawAndCompare(std::ostream& stream, SDL_Renderer* renderer, const std::vector<Cell>& cells, const SDL_Color* expected, bool sorted)
+	{
+		RenderQueue queue;
+		for (std::size_t i = 0; i < cells.size(); i++)
+		{
+			DrawCommand command;
+			command.texture = cells[i].texture;
+			command.dstRect = SDL_Rect{ static_cast<int>(i) * CELL_STRIDE, 0, CELL_SIZE, CELL_SIZE };
+			command.color = cells[i].texture == nullptr ? cells[i].color : SDL_Color{ 255, 255, 255, 255 };
+			queue.submit(command, RenderLayer::Midground, cells[i].depth);
+		}
+
+		if (sorted)
+		{
+			queue.sort();
+		}
+
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderClear(renderer);
+
+		SpriteBatcher batcher;
+		batcher.draw(renderer, queue);
+
+		std::vector<Uint32> pixels(CELL_STRIDE * CELL_COUNT * CELL_SIZE);
+		SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, pixels.data(), CELL_STRIDE * CELL_COUNT * sizeof(Uint32));
+
+		bool passed = true;
+		for (int i = 0; i < CELL_COUNT; i++)
+		{
+			Uint32 pixel = pixels[(CELL_SIZE / 2) * CELL_STRIDE * CELL_COUNT + i * CELL_STRIDE + CELL_SIZE / 2];
+			Uint8 r = static_cast<Uint8>(pixel >> 16);
+			Uint8 g = static_cast<Uint8>(pixel >> 8);
+			Uint8 b = static_cast<Uint8>(pixel);
+
+			if (r != expected[i].r || g != expected[i].g || b != expected[i].b)
+			{
+				stream << "SpriteBatcher check failed (" << (sorted ? "sorted" : "submission order") << "): cell " << i << " is "
+					<< static_cast<int>(r) << ", " << static_cast<int>(g) << ", " << static_cast<int>(b) << " instead of "
+					<< static_cast<int>(expected[i].r) << ", " << static_cast<int>(expected[i].g) << ", " << static_cast<int>(expected[i].b) << std::endl;
+				passed = false;
+			}
+		}
+
+		return passed;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::ostream& stream = std::cout;
+
+	SDL_Surface* target = SDL_CreateRGBSurfaceWithFormat(0, CELL_STRIDE * CELL_COUNT, CELL_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+	SDL_Renderer* renderer = target != nullptr ? SDL_CreateSoftwareRenderer(target) : nullptr;
+	if (renderer == nullptr)
+	{
+		stream << "SpriteBatcher check couldn't create a software renderer: " << SDL_GetError() << std::endl;
+		SDL_FreeSurface(target);
+		return 1;
+	}
+
+	const SDL_Color red = { 255, 0, 0, 255 };
+	const SDL_Color yellow = { 255, 255, 0, 255 };
+	const SDL_Color green = { 0, 255, 0, 255 };
+	const SDL_Color blue = { 0, 0, 255, 255 };
+
+	SDL_Texture* redTexture = createSolidTexture(renderer, red);
+	SDL_Texture* yellowTexture = createSolidTexture(renderer, yellow);
+
+	// The first depth binds the red texture, so the next one is drawn starting from its red run.
+	// Fills come before, between and after sprites of both textures, and the last depth starts with a sprite
+	std::vector<Cell> cells = {
+		{ 0, redTexture, red },
+		{ 1, nullptr, green },
+		{ 1, redTexture, red },
+		{ 1, nullptr, blue },
+		{ 1, yellowTexture, yellow },
+		{ 1, nullptr, green },
+		{ 2, yellowTexture, yellow },
+		{ 2, nullptr, blue },
+		{ 2, redTexture, red }
+	};
+	const SDL_Color expected[CELL_COUNT] = { red, green, red, blue, yellow, green, yellow, blue, red };
+
+	bool passed = redTexture != nullptr && yellowTexture != nullptr;
+	if (!passed)
+	{
+		stream << "SpriteBatcher check couldn't create its textures: " << SDL_GetError() << std::endl;
+	}
+	else
+	{
+		passed = drawAndCompare(stream, renderer, cells, expected, false) && passed;
+		passed = drawAndCompare(stream, renderer, cells, expected, true) && passed;
+	}
+
+	stream << "SpriteBatcher check " << (passed ? "passed" : "failed") << std::endl;
+
+	SDL_DestroyTexture(redTexture);
+	SDL_DestroyTexture(yellowTexture);
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(target);
+
+	return passed ? 0 : 1;
+}
@@ -1,6 +1,12 @@
 #include "AssetManager.h"
 #include "Engine.h"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include "Rendering/AtlasPacker.h"
+#include "Profiling/Profiler.h"
+#include "Profiling/AllocationTracker.h"
 
 AssetManager::AssetManager()
 {
@@ -30,6 +36,18 @@ void AssetManager::clear()
 	_textures.clear();
 
 
+	for (auto& page : _atlasPages)
+	{
+		SDL_DestroyTexture(page);
+	}
+	_atlasPages.clear();
+	_atlasRegions.clear();
+	_pendingAtlasImages.clear();
+
+
+	_glyphAtlases.clear();
+	_textTextureCache.clear();
+
 	for (auto& font : _fonts)
 	{
 		TTF_CloseFont(font.second);
@@ -58,8 +76,13 @@ void AssetManager::clear()
 
 void AssetManager::loadTexture(const std::string& id, const std::string& path)
 {
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("AssetManager");
+
 	if (!_textures.count(id))
 	{
+		auto rendererLock = Engine::instance().lockRenderer();
+
 		SDL_Texture* texture = IMG_LoadTexture(Engine::instance().getRenderer(), path.c_str());
 		if (texture)
 		{
@@ -73,13 +96,282 @@ void AssetManager::loadTexture(const std::string& id, const std::string& path)
 	}
 }
 
+void AssetManager::addTexture(const std::string& id, SDL_Texture* texture)
+{
+	if (!_textures.count(id))
+	{
+		_textures.emplace(id, texture);
+	}
+	else
+	{
+		std::cerr << "Texture [" << id << "] already exists!" << std::endl;
+		SDL_DestroyTexture(texture);
+	}
+}
+
 SDL_Texture* AssetManager::getTexture(const std::string& id)
 {
-	return _textures.count(id) ? _textures[id] : nullptr;
+	auto texture = _textures.find(id);
+	if (texture != _textures.end())
+	{
+		return texture->second;
+	}
+
+	// Drawing the page with a (0, 0) based src rect would show whatever image is packed there
+	if (_atlasRegions.count(id))
+	{
+		std::cerr << "Texture [" << id << "] is packed into an atlas, get it with its offset or region instead!" << std::endl;
+	}
+
+	return nullptr;
+}
+
+SDL_Texture* AssetManager::getTexture(const std::string& id, SDL_Point& offset)
+{
+	offset = { 0, 0 };
+
+	auto texture = _textures.find(id);
+	if (texture != _textures.end())
+	{
+		return texture->second;
+	}
+
+	auto region = _atlasRegions.find(id);
+	if (region != _atlasRegions.end())
+	{
+		offset = { region->second.rect.x, region->second.rect.y };
+		return region->second.texture;
+	}
+
+	return nullptr;
+}
+
+SDL_Texture* AssetManager::getTextureRegion(const std::string& id, SDL_Rect& region)
+{
+	region = { 0, 0, 0, 0 };
+
+	auto texture = _textures.find(id);
+	if (texture != _textures.end())
+	{
+		SDL_QueryTexture(texture->second, nullptr, nullptr, &region.w, &region.h);
+		return texture->second;
+	}
+
+	auto atlasRegion = _atlasRegions.find(id);
+	if (atlasRegion != _atlasRegions.end())
+	{
+		region = atlasRegion->second.rect;
+		return atlasRegion->second.texture;
+	}
+
+	return nullptr;
+}
+
+void AssetManager::addToAtlas(const std::string& id, const std::string& path)
+{
+	_pendingAtlasImages.emplace_back(id, path);
+}
+
+void AssetManager::buildAtlases(int pageSize, const std::string& savePath)
+{
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("AssetManager");
+
+	struct Image
+	{
+		std::string id;
+		SDL_Surface* surface;
+		std::size_t page;
+		SDL_Rect rect;
+	};
+
+	std::vector<Image> images;
+	images.reserve(_pendingAtlasImages.size());
+
+	for (auto& pending : _pendingAtlasImages)
+	{
+		if (_textures.count(pending.first) || _atlasRegions.count(pending.first))
+		{
+			continue;
+		}
+
+		SDL_Surface* loaded = IMG_Load(pending.second.c_str());
+		if (!loaded)
+		{
+			std::cerr << "Failed to load texture! Error: " << IMG_GetError() << std::endl;
+			continue;
+		}
+
+		// Pages are RGBA, so convert everything up front to blit without blending
+		SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+		SDL_FreeSurface(loaded);
+
+		if (!surface)
+		{
+			std::cerr << "Failed to convert texture! Error: " << SDL_GetError() << std::endl;
+			continue;
+		}
+
+		if (surface->w > pageSize - 2 * ATLAS_PADDING || surface->h > pageSize - 2 * ATLAS_PADDING)
+		{
+			// Too large for a page, fall back to a texture of its own
+			auto rendererLock = Engine::instance().lockRenderer();
+			SDL_Texture* texture = SDL_CreateTextureFromSurface(Engine::instance().getRenderer(), surface);
+			SDL_FreeSurface(surface);
+
+			if (!texture)
+			{
+				std::cerr << "Failed to create texture! Error: " << SDL_GetError() << std::endl;
+				continue;
+			}
+
+			_textures.emplace(pending.first, texture);
+			std::cout << "Texture: [" << pending.second << "] is too large for the atlas, loaded on its own" << std::endl;
+			continue;
+		}
+
+		images.push_back({ pending.first, surface, 0u, { 0, 0, 0, 0 } });
+	}
+	_pendingAtlasImages.clear();
+
+	// MaxRects packs tighter when the largest images go first
+	std::sort(images.begin(), images.end(), [](const Image& a, const Image& b)
+		{
+			int aMax = SDL_max(a.surface->w, a.surface->h);
+			int bMax = SDL_max(b.surface->w, b.surface->h);
+			return aMax != bMax ? aMax > bMax : a.surface->w * a.surface->h > b.surface->w * b.surface->h;
+		});
+
+	std::vector<AtlasPacker> packers;
+	for (auto& image : images)
+	{
+		bool packed = false;
+		for (std::size_t page = 0; page < packers.size() && !packed; page++)
+		{
+			packed = packers[page].insert(image.surface->w, image.surface->h, image.rect);
+			image.page = page;
+		}
+
+		if (!packed)
+		{
+			packers.emplace_back(pageSize, pageSize, ATLAS_PADDING);
+			packers.back().insert(image.surface->w, image.surface->h, image.rect);
+			image.page = packers.size() - 1u;
+		}
+	}
+
+	std::vector<SDL_Surface*> pageSurfaces;
+	for (std::size_t page = 0; page < packers.size(); page++)
+	{
+		pageSurfaces.push_back(SDL_CreateRGBSurfaceWithFormat(0, pageSize, pageSize, 32, SDL_PIXELFORMAT_RGBA32));
+	}
+
+	for (auto& image : images)
+	{
+		SDL_SetSurfaceBlendMode(image.surface, SDL_BLENDMODE_NONE);
+		SDL_BlitSurface(image.surface, nullptr, pageSurfaces[image.page], &image.rect);
+		SDL_FreeSurface(image.surface);
+	}
+
+	if (!savePath.empty())
+	{
+		std::ofstream description(savePath + ".atlas");
+
+		for (std::size_t page = 0; page < pageSurfaces.size(); page++)
+		{
+			std::string pagePath = savePath + "_" + std::to_string(page) + ".png";
+			if (IMG_SavePNG(pageSurfaces[page], pagePath.c_str()) != 0)
+			{
+				std::cerr << "Failed to save atlas page! Error: " << IMG_GetError() << std::endl;
+			}
+
+			description << "page " << pagePath << "\n";
+			for (auto& image : images)
+			{
+				if (image.page == page)
+				{
+					description << image.id << " " << image.rect.x << " " << image.rect.y << " " << image.rect.w << " " << image.rect.h << "\n";
+				}
+			}
+		}
+	}
+
+	auto rendererLock = Engine::instance().lockRenderer();
+
+	std::size_t firstPage = _atlasPages.size();
+	for (std::size_t page = 0; page < pageSurfaces.size(); page++)
+	{
+		_atlasPages.push_back(SDL_CreateTextureFromSurface(Engine::instance().getRenderer(), pageSurfaces[page]));
+		SDL_FreeSurface(pageSurfaces[page]);
+
+		std::cout << "Atlas page " << page << ": " << static_cast<int>(packers[page].occupancy() * 100.f) << "% used" << std::endl;
+	}
+
+	for (auto& image : images)
+	{
+		_atlasRegions.emplace(image.id, AtlasRegion{ _atlasPages[firstPage + image.page], image.rect });
+	}
+
+	std::cout << "Atlas: " << images.size() << " images packed into " << pageSurfaces.size() << " pages" << std::endl;
+}
+
+void AssetManager::loadAtlas(const std::string& path)
+{
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("AssetManager");
+
+	std::ifstream description(path);
+	if (!description)
+	{
+		std::cerr << "Failed to load atlas! Can't open [" << path << "]" << std::endl;
+		return;
+	}
+
+	SDL_Texture* page = nullptr;
+	std::string line;
+	while (std::getline(description, line))
+	{
+		std::istringstream fields(line);
+		std::string id;
+		fields >> id;
+
+		if (id == "page")
+		{
+			// The path is the rest of the line, so it may contain spaces
+			std::string pagePath;
+			std::getline(fields >> std::ws, pagePath);
+			pagePath.erase(pagePath.find_last_not_of(" \t\r") + 1u);
+
+			{
+				auto rendererLock = Engine::instance().lockRenderer();
+				page = IMG_LoadTexture(Engine::instance().getRenderer(), pagePath.c_str());
+			}
+			if (page)
+			{
+				_atlasPages.push_back(page);
+			}
+			else
+			{
+				std::cerr << "Failed to load atlas page! Error: " << IMG_GetError() << std::endl;
+			}
+		}
+		else if (!id.empty() && page != nullptr && !_atlasRegions.count(id))
+		{
+			AtlasRegion region;
+			region.texture = page;
+			fields >> region.rect.x >> region.rect.y >> region.rect.w >> region.rect.h;
+			_atlasRegions.emplace(id, region);
+		}
+	}
+
+	std::cout << "Atlas: [" << path << "] loaded!" << std::endl;
 }
 
 void AssetManager::loadFont(const std::string& id, const std::string& path, int fontSize)
 {
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("AssetManager");
+
 	if (!_fonts.count(id))
 	{
 		TTF_Font* font = TTF_OpenFont(path.c_str(), fontSize);
@@ -101,8 +393,28 @@ TTF_Font* AssetManager::getFont(const std::string& id)
 	return _fonts.count(id) ? _fonts[id] : nullptr;
 }
 
+GlyphAtlas* AssetManager::getGlyphAtlas(const std::string& id)
+{
+	auto glyphAtlas = _glyphAtlases.find(id);
+	if (glyphAtlas != _glyphAtlases.end())
+	{
+		return glyphAtlas->second.get();
+	}
+
+	TTF_Font* font = getFont(id);
+	if (font == nullptr)
+	{
+		return nullptr;
+	}
+
+	return _glyphAtlases.emplace(id, std::make_unique<GlyphAtlas>(Engine::instance().getRenderer(), font)).first->second.get();
+}
+
 void AssetManager::loadMusic(const std::string& id, const std::string& path)
 {
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("AssetManager");
+
 	if (!_music.count(id))
 	{
 		Mix_Music* music = Mix_LoadMUS(path.c_str());
@@ -126,6 +438,9 @@ Mix_Music* AssetManager::getMusic(const std::string& id)
 
 void AssetManager::loadSoundEffect(const std::string& id, const std::string& path)
 {
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("AssetManager");
+
 	if (!_soundEffects.count(id))
 	{
 		Mix_Chunk* sfx = Mix_LoadWAV(path.c_str());
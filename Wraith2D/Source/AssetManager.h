@@ -5,10 +5,14 @@
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
 
+#include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "Singleton.h"
+#include "Rendering/GlyphAtlas.h"
+#include "Rendering/TextTextureCache.h"
 
 class AssetManager : public Singleton<AssetManager>
 {
@@ -30,11 +34,60 @@ public:
 
 	/// <summary>
 	/// Returns a previously loaded texture identified by id.
+	/// Images packed into an atlas are refused with an error, their texture is the whole atlas page,
+	/// so get them with their offset or region instead.
 	/// </summary>
 	/// <param name="id">The texture ID</param>
-	/// <returns>A pointer to the texture, or nullptr if it doesn't exist</returns>
+	/// <returns>A pointer to the texture, or nullptr if it doesn't exist or is packed into an atlas</returns>
 	SDL_Texture* getTexture(const std::string& id);
 
+	/// <summary>
+	/// Adds a texture created elsewhere, e.g. generated at runtime. The AssetManager takes ownership of it.
+	/// </summary>
+	/// <param name="id">The ID that will be used to identify this texture</param>
+	/// <param name="texture">The texture</param>
+	void addTexture(const std::string& id, SDL_Texture* texture);
+
+	/// <summary>
+	/// Returns a previously loaded texture identified by id, along with the position of the image inside it.
+	/// The position is only non-zero for images packed into an atlas.
+	/// </summary>
+	/// <param name="id">The texture ID</param>
+	/// <param name="offset">The position of the image inside the returned texture</param>
+	/// <returns>A pointer to the texture, or nullptr if it doesn't exist</returns>
+	SDL_Texture* getTexture(const std::string& id, SDL_Point& offset);
+
+	/// <summary>
+	/// Returns a previously loaded texture identified by id, along with the rect of the image inside it.
+	/// The rect covers the whole texture unless the image was packed into an atlas.
+	/// </summary>
+	/// <param name="id">The texture ID</param>
+	/// <param name="region">The rect of the image inside the returned texture</param>
+	/// <returns>A pointer to the texture, or nullptr if it doesn't exist</returns>
+	SDL_Texture* getTextureRegion(const std::string& id, SDL_Rect& region);
+
+	/// <summary>
+	/// Queues an image to be packed into a texture atlas by buildAtlases().
+	/// Sprites use the id like any other texture ID once the atlas is built.
+	/// </summary>
+	/// <param name="id">The ID that will be used to identify this image. Must not contain whitespace</param>
+	/// <param name="path">The path to the image asset</param>
+	void addToAtlas(const std::string& id, const std::string& path);
+
+	/// <summary>
+	/// Packs every queued image into as few atlas pages as possible, so sprites using them share textures.
+	/// Images too large for a page are loaded as standalone textures.
+	/// </summary>
+	/// <param name="pageSize">The width and height of each atlas page</param>
+	/// <param name="savePath">If not empty, the pages and their description are saved with this path prefix so loadAtlas() can load them later</param>
+	void buildAtlases(int pageSize = 2048, const std::string& savePath = "");
+
+	/// <summary>
+	/// Loads an atlas saved by buildAtlases(), skipping the packing at load time.
+	/// </summary>
+	/// <param name="path">The path to the .atlas description file</param>
+	void loadAtlas(const std::string& path);
+
 	/// <summary>
 	/// Loads a new font asset.
 	/// </summary>
@@ -50,6 +103,19 @@ public:
 	/// <returns>A pointer to the font, or nullptr if it doesn't exist</returns>
 	TTF_Font* getFont(const std::string& id);
 
+	/// <summary>
+	/// Returns the glyph atlas of a previously loaded font, creating it the first time.
+	/// </summary>
+	/// <param name="id">The font ID</param>
+	/// <returns>A pointer to the glyph atlas, or nullptr if the font doesn't exist</returns>
+	GlyphAtlas* getGlyphAtlas(const std::string& id);
+
+	/// <summary>
+	/// Returns the cache of text textures shared by Text components with the same content.
+	/// </summary>
+	/// <returns>A reference to the text texture cache</returns>
+	inline TextTextureCache& textTextureCache() { return _textTextureCache; }
+
 	/// <summary>
 	/// Loads a new music asset.
 	/// </summary>
@@ -79,8 +145,21 @@ public:
 	Mix_Chunk* getSoundEffect(const std::string& id);
 
 private:
+	struct AtlasRegion
+	{
+		SDL_Texture* texture = nullptr;
+		SDL_Rect rect = { 0, 0, 0, 0 };
+	};
+
+	static constexpr int ATLAS_PADDING = 2;
+
 	std::unordered_map<std::string, SDL_Texture*> _textures;
+	std::unordered_map<std::string, AtlasRegion> _atlasRegions;
+	std::vector<SDL_Texture*> _atlasPages;
+	std::vector<std::pair<std::string, std::string>> _pendingAtlasImages;
 	std::unordered_map<std::string, TTF_Font*> _fonts;
+	std::unordered_map<std::string, std::unique_ptr<GlyphAtlas>> _glyphAtlases;
+	TextTextureCache _textTextureCache;
 	std::unordered_map<std::string, Mix_Music*> _music;
 	std::unordered_map<std::string, Mix_Chunk*> _soundEffects;
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "Clock.h"
+#include <cmath>
+
+constexpr double FPS_COUNT_DELAY = 0.5;
+
+Clock::Clock()
+{
+	reset();
+}
+
+void Clock::reset()
+{
+	_frequency = SDL_GetPerformanceFrequency();
+	_lastCounter = SDL_GetPerformanceCounter();
+	_lastFPSCounter = _lastCounter;
+
+	_accumulator = 0.0;
+	_deltaTime = 0.0;
+	_unscaledDeltaTime = 0.0;
+	_time = 0.0;
+	_unscaledTime = 0.0;
+
+	_frameCount = 0u;
+	_stepCount = 0u;
+	_framesSinceFPSCount = 0u;
+	_fps = 0u;
+}
+
+void Clock::tick()
+{
+	Uint64 counter = SDL_GetPerformanceCounter();
+	double elapsed = static_cast<double>(counter - _lastCounter) / static_cast<double>(_frequency);
+	_lastCounter = counter;
+
+	_unscaledDeltaTime = elapsed;
+	_unscaledTime += elapsed;
+
+	// Clamp long frames so a stall doesn't have to be caught up with a burst of fixed steps
+	if (elapsed > _maxFrameTime)
+	{
+		elapsed = _maxFrameTime;
+	}
+
+	_deltaTime = _paused ? 0.0 : elapsed * _timeScale;
+	_accumulator += _deltaTime;
+	_stepsThisFrame = 0u;
+
+	++_frameCount;
+	++_framesSinceFPSCount;
+
+	double fpsWindow = static_cast<double>(counter - _lastFPSCounter) / static_cast<double>(_frequency);
+	if (fpsWindow >= FPS_COUNT_DELAY)
+	{
+		_fps = static_cast<unsigned int>(_framesSinceFPSCount / fpsWindow + 0.5);
+		_framesSinceFPSCount = 0u;
+		_lastFPSCounter = counter;
+	}
+}
+
+bool Clock::consumeFixedStep()
+{
+	if (_accumulator < _fixedDeltaTime)
+	{
+		return false;
+	}
+
+	if (_stepsThisFrame >= _maxStepsPerFrame)
+	{
+		// Too far behind to catch up, drop the backlog but keep the partial step for interpolation
+		_accumulator = std::fmod(_accumulator, _fixedDeltaTime);
+
+		return false;
+	}
+
+	_accumulator -= _fixedDeltaTime;
+	_time += _fixedDeltaTime;
+	++_stepsThisFrame;
+	++_stepCount;
+
+	return true;
+}
+
+void Clock::setFixedStepRate(double stepsPerSecond)
+{
+	if (stepsPerSecond > 0.0)
+	{
+		_fixedDeltaTime = 1.0 / stepsPerSecond;
+	}
+}
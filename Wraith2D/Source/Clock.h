@@ -0,0 +1,164 @@
+#pragma once
+
+#include <SDL.h>
+
+class Clock
+{
+public:
+	Clock();
+
+	/// <summary>
+	/// Restarts the clock, discarding any accumulated time.
+	/// </summary>
+	void reset();
+
+	/// <summary>
+	/// Samples the high-resolution counter and advances the clock by the time elapsed since the last tick.
+	/// Should be called once per frame.
+	/// </summary>
+	void tick();
+
+	/// <summary>
+	/// Consumes one fixed simulation step from the accumulated frame time.
+	/// Call it in a loop until it returns false to run every pending step.
+	/// </summary>
+	/// <returns>True if a step should be simulated, false if not</returns>
+	bool consumeFixedStep();
+
+	/// <summary>
+	/// Sets the rate at which the simulation is stepped.
+	/// </summary>
+	/// <param name="stepsPerSecond">The number of fixed steps per second</param>
+	void setFixedStepRate(double stepsPerSecond);
+
+	/// <summary>
+	/// Sets the longest frame time the clock will accept. Longer frames (breakpoints, window drags, etc.)
+	/// are clamped to avoid a spiral of catch-up steps.
+	/// </summary>
+	/// <param name="seconds">The maximum frame time in seconds</param>
+	inline void setMaxFrameTime(double seconds) { _maxFrameTime = seconds; }
+
+	/// <summary>
+	/// Sets the maximum number of fixed steps simulated in a single frame.
+	/// </summary>
+	/// <param name="maxSteps">The maximum number of steps</param>
+	inline void setMaxStepsPerFrame(unsigned int maxSteps) { _maxStepsPerFrame = maxSteps; }
+
+	/// <summary>
+	/// Sets the time scale applied to the simulation. 1 is real time, 0.5 is half speed, etc.
+	/// </summary>
+	/// <param name="timeScale">The new time scale</param>
+	inline void setTimeScale(float timeScale) { _timeScale = timeScale < 0.f ? 0.f : timeScale; }
+
+	/// <summary>
+	/// Returns the time scale applied to the simulation.
+	/// </summary>
+	/// <returns>The time scale</returns>
+	inline float getTimeScale() const { return _timeScale; }
+
+	/// <summary>
+	/// Pauses or resumes the simulation. Rendering keeps running while paused.
+	/// </summary>
+	/// <param name="paused">The new paused state</param>
+	inline void setPaused(bool paused) { _paused = paused; }
+
+	/// <summary>
+	/// Checks whether the simulation is paused.
+	/// </summary>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isPaused() const { return _paused; }
+
+	/// <summary>
+	/// Returns the scaled time difference between this frame and the last, in seconds.
+	/// Returns 0 while paused.
+	/// </summary>
+	/// <returns>The scaled frame time</returns>
+	inline float deltaTime() const { return static_cast<float>(_deltaTime); }
+
+	/// <summary>
+	/// Returns the real time difference between this frame and the last, in seconds.
+	/// Ignores time scale and pause.
+	/// </summary>
+	/// <returns>The unscaled frame time</returns>
+	inline float unscaledDeltaTime() const { return static_cast<float>(_unscaledDeltaTime); }
+
+	/// <summary>
+	/// Returns the duration of a fixed simulation step, in seconds.
+	/// </summary>
+	/// <returns>The fixed step duration</returns>
+	inline float fixedDeltaTime() const { return static_cast<float>(_fixedDeltaTime); }
+
+	/// <summary>
+	/// Returns how far the current frame is between the last simulated step and the next one, in the [0,1] range.
+	/// Used to interpolate simulation state when rendering.
+	/// </summary>
+	/// <returns>The interpolation ratio</returns>
+	inline float interpolationAlpha() const { return static_cast<float>(_accumulator / _fixedDeltaTime); }
+
+	/// <summary>
+	/// Returns the simulation time, in seconds. Only advances with fixed steps, so it respects time scale and pause.
+	/// </summary>
+	/// <returns>The simulation time</returns>
+	inline double time() const { return _time; }
+
+	/// <summary>
+	/// Returns the real time elapsed since the clock was reset, in seconds.
+	/// </summary>
+	/// <returns>The real time</returns>
+	inline double unscaledTime() const { return _unscaledTime; }
+
+	/// <summary>
+	/// Returns the number of frames ticked since the clock was reset.
+	/// </summary>
+	/// <returns>The frame count</returns>
+	inline Uint64 frameCount() const { return _frameCount; }
+
+	/// <summary>
+	/// Returns the number of fixed steps simulated since the clock was reset.
+	/// </summary>
+	/// <returns>The step count</returns>
+	inline Uint64 stepCount() const { return _stepCount; }
+
+	/// <summary>
+	/// Returns the frames per second, averaged over a short window.
+	/// </summary>
+	/// <returns>Frames per second</returns>
+	inline unsigned int FPS() const { return _fps; }
+
+	/// <summary>
+	/// Returns the current value of the high-resolution counter.
+	/// </summary>
+	/// <returns>The counter value</returns>
+	static Uint64 now() { return SDL_GetPerformanceCounter(); }
+
+	/// <summary>
+	/// Converts a difference between two counter values to seconds.
+	/// </summary>
+	/// <param name="counterDelta">The counter difference</param>
+	/// <returns>The difference in seconds</returns>
+	static double toSeconds(Uint64 counterDelta) { return static_cast<double>(counterDelta) / static_cast<double>(SDL_GetPerformanceFrequency()); }
+
+private:
+	Uint64 _frequency = 1u;
+	Uint64 _lastCounter = 0u;
+	Uint64 _lastFPSCounter = 0u;
+
+	double _fixedDeltaTime = 1.0 / 60.0;
+	double _maxFrameTime = 0.25;
+	unsigned int _maxStepsPerFrame = 8u;
+	unsigned int _stepsThisFrame = 0u;
+
+	double _accumulator = 0.0;
+	double _deltaTime = 0.0;
+	double _unscaledDeltaTime = 0.0;
+	double _time = 0.0;
+	double _unscaledTime = 0.0;
+
+	float _timeScale = 1.f;
+	bool _paused = false;
+
+	Uint64 _frameCount = 0u;
+	Uint64 _stepCount = 0u;
+	unsigned int _framesSinceFPSCount = 0u;
+	unsigned int _fps = 0u;
+};
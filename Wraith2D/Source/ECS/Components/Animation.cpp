@@ -4,6 +4,6 @@
 void Animation::init()
 {
 	_sprite = &entity->getComponent<Sprite>();
-	AnimationInfo animInfo = _animations.at(_currentAnimation);
+	const AnimationInfo& animInfo = _animations.at(_currentAnimation);
 	_sprite->setTexture(animInfo.textureID, animInfo.rowIndex);
 }
\ No newline at end of file
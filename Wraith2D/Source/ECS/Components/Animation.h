@@ -67,7 +67,7 @@ public:
 		if (_animations.count(animation))
 		{
 			_currentAnimation = animation;
-			AnimationInfo animInfo = _animations.at(_currentAnimation);
+			const AnimationInfo& animInfo = _animations.at(_currentAnimation);
 			_sprite->setTexture(animInfo.textureID, animInfo.rowIndex);
 			reset();
 		}
@@ -77,7 +77,7 @@ public:
 	/// Returns the current animation.
 	/// </summary>
 	/// <returns>A struct with the animation info</returns>
-	inline AnimationInfo getCurrentAnimation()
+	inline const AnimationInfo& getCurrentAnimation() const
 	{
 		return _animations.at(_currentAnimation);
 	}
@@ -1,10 +1,12 @@
 #include "Button.h"
 #include "../../InputManager.h"
+#include "../../Engine.h"
 #include "../../Math/Vector2.h"
 
 bool Button::mouseHovering()
 {
-	Vector2 mousePos = InputManager::mousePosition();
+	// Sprites are placed in world coordinates, so hit test the mouse in the world too
+	Vector2 mousePos = Engine::instance().screenToWorld(InputManager::mousePosition());
 
 	return mousePos.x > _sprite->dstRect()->x && mousePos.x < _sprite->dstRect()->x + _sprite->dstRect()->w
 		&& mousePos.y > _sprite->dstRect()->y && mousePos.y < _sprite->dstRect()->y + _sprite->dstRect()->h;
@@ -27,7 +27,7 @@ public:
 	/// Returns the texture ID of the button in its default state.
 	/// </summary>
 	/// <returns>The default texture ID</returns>
-	inline std::string getDefaultTextureID() { return _defaultTextureID; }
+	inline const std::string& getDefaultTextureID() const { return _defaultTextureID; }
 
 	/// <summary>
 	/// Sets the texture ID of the Button in its default state.
@@ -39,7 +39,7 @@ public:
 	/// Returns the texture ID of the button in its hovered state.
 	/// </summary>
 	/// <returns>The hover texture ID</returns>
-	inline std::string getHoverTextureID() { return _hoverTextureID; }
+	inline const std::string& getHoverTextureID() const { return _hoverTextureID; }
 
 	/// <summary>
 	/// Sets the texture ID of the Button in its hovered state.
@@ -51,7 +51,7 @@ public:
 	/// Returns the texture ID of the button in its down state.
 	/// </summary>
 	/// <returns>The down texture ID</returns>
-	inline std::string getDownTextureID() { return _downTextureID; }
+	inline const std::string& getDownTextureID() const { return _downTextureID; }
 
 	/// <summary>
 	/// Sets the texture ID of the Button in its down state.
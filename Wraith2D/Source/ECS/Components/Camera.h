@@ -0,0 +1,144 @@
+#pragma once
+
+#include <SDL.h>
+#include <cmath>
+#include <cstdint>
+
+#include "../ECS.h"
+#include "Transform.h"
+#include "../../RenderLayer.h"
+
+/// <summary>
+/// Renders the part of the world in front of it into a viewport of the screen.
+/// The Transform position is the top left corner of the view in world coordinates.
+/// Cameras cull and draw independently, so several of them can show the same entities for split-screen or a minimap.
+/// </summary>
+class Camera : public Component
+{
+public:
+	/// <summary>
+	/// Creates a camera.
+	/// </summary>
+	/// <param name="viewport">The area of the screen to draw into</param>
+	/// <param name="zoom">The scale the world is drawn at, above 1 zooms in</param>
+	/// <param name="order">Cameras are drawn from the lowest to the highest order, so higher ones are drawn on top</param>
+	Camera(const SDL_Rect& viewport, float zoom = 1.f, int order = 0)
+		: _viewport(viewport)
+		, _zoom(zoom > 0.f ? zoom : 1.f)
+		, _order(order)
+	{ }
+
+	void init() override
+	{
+		transform = &entity->getComponent<Transform>();
+	}
+
+	/// <summary>
+	/// Returns the area of the world the camera sees.
+	/// </summary>
+	/// <param name="alpha">The interpolation ratio between the last two simulation steps</param>
+	/// <returns>The view rect in world coordinates</returns>
+	inline SDL_Rect worldView(float alpha = 1.f) const
+	{
+		Vector2 position = transform->interpolatedPosition(alpha);
+		return SDL_Rect{ static_cast<int>(std::round(position.x)), static_cast<int>(std::round(position.y)),
+			static_cast<int>(std::ceil(_viewport.w / _zoom)), static_cast<int>(std::ceil(_viewport.h / _zoom)) };
+	}
+
+	/// <summary>
+	/// Converts a point on the screen to world coordinates.
+	/// </summary>
+	/// <param name="screenPosition">The point in screen coordinates</param>
+	/// <returns>The point in world coordinates</returns>
+	inline Vector2 screenToWorld(const Vector2& screenPosition) const
+	{
+		return Vector2((screenPosition.x - _viewport.x) / _zoom + transform->position.x, (screenPosition.y - _viewport.y) / _zoom + transform->position.y);
+	}
+
+	/// <summary>
+	/// Converts a point in the world to screen coordinates.
+	/// </summary>
+	/// <param name="worldPosition">The point in world coordinates</param>
+	/// <returns>The point in screen coordinates</returns>
+	inline Vector2 worldToScreen(const Vector2& worldPosition) const
+	{
+		return Vector2((worldPosition.x - transform->position.x) * _zoom + _viewport.x, (worldPosition.y - transform->position.y) * _zoom + _viewport.y);
+	}
+
+	/// <summary>
+	/// Checks whether a point on the screen is inside the viewport.
+	/// </summary>
+	/// <param name="screenPosition">The point in screen coordinates</param>
+	/// <returns>True if it is, false if not</returns>
+	inline bool viewportContains(const Vector2& screenPosition) const
+	{
+		return screenPosition.x >= _viewport.x && screenPosition.x < _viewport.x + _viewport.w
+			&& screenPosition.y >= _viewport.y && screenPosition.y < _viewport.y + _viewport.h;
+	}
+
+	/// <summary>
+	/// Returns the area of the screen the camera draws into.
+	/// </summary>
+	/// <returns>The viewport in screen coordinates</returns>
+	inline const SDL_Rect& getViewport() const { return _viewport; }
+
+	/// <summary>
+	/// Sets the area of the screen the camera draws into.
+	/// </summary>
+	/// <param name="viewport">The viewport in screen coordinates</param>
+	inline void setViewport(const SDL_Rect& viewport) { _viewport = viewport; }
+
+	/// <summary>
+	/// Returns the zoom.
+	/// </summary>
+	/// <returns>The zoom</returns>
+	inline float getZoom() const { return _zoom; }
+
+	/// <summary>
+	/// Sets the scale the world is drawn at, above 1 zooms in.
+	/// </summary>
+	/// <param name="zoom">The new zoom</param>
+	inline void setZoom(float zoom) { _zoom = zoom > 0.f ? zoom : _zoom; }
+
+	/// <summary>
+	/// Returns the draw order.
+	/// </summary>
+	/// <returns>The draw order</returns>
+	inline int getOrder() const { return _order; }
+
+	/// <summary>
+	/// Sets the draw order. Cameras are drawn from the lowest to the highest order.
+	/// </summary>
+	/// <param name="order">The new draw order</param>
+	inline void setOrder(int order) { _order = order; }
+
+	/// <summary>
+	/// Shows or hides a render layer in this camera, e.g. to leave the UI out of a minimap.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="visible">Flag to draw the layer or not</param>
+	inline void setLayerVisible(RenderLayer layer, bool visible)
+	{
+		_layerMask = visible ? (_layerMask | (1u << layer)) : (_layerMask & ~(1u << layer));
+	}
+
+	/// <summary>
+	/// Checks whether a render layer is drawn by this camera.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isLayerVisible(RenderLayer layer) const { return (_layerMask & (1u << layer)) != 0u; }
+
+	/// <summary>
+	/// Returns the Transform component attached to the same Entity as this Camera.
+	/// </summary>
+	/// <returns>The Transform</returns>
+	inline Transform& getTransform() { return *transform; }
+
+private:
+	SDL_Rect _viewport = { 0, 0, 0, 0 };
+	float _zoom = 1.f;
+	int _order = 0;
+	uint32_t _layerMask = 0xFFFFFFFFu;
+	Transform* transform = nullptr;
+};
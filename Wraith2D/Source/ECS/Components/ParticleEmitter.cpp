@@ -0,0 +1,196 @@
+#include "ParticleEmitter.h"
+
+#include <cmath>
+
+#include "../../AssetManager.h"
+#include "../../Profiling/Profiler.h"
+
+ParticleEmitter::ParticleEmitter(RenderLayer renderLayer, int depth, const std::string& textureID, int srcX, int srcY, int srcWidth, int srcHeight, int capacity, const Settings& settings, float relativePosX, float relativePosY)
+	: Renderable(renderLayer, depth, relativePosX, relativePosY)
+	, _settings(settings)
+	, _textureID(textureID)
+	, _imageRect{ srcX, srcY, srcWidth, srcHeight }
+	, _capacity(SDL_max(capacity, 0))
+	, _random(std::random_device{}())
+{
+	// The pool never grows, so the arrays are allocated once here
+	_positionX.resize(_capacity);
+	_positionY.resize(_capacity);
+	_velocityX.resize(_capacity);
+	_velocityY.resize(_capacity);
+	_life.resize(_capacity);
+	_lifeRate.resize(_capacity);
+	_quads.reserve(_capacity);
+}
+
+void ParticleEmitter::init()
+{
+	transform = &entity->getComponent<Transform>();
+	texture = AssetManager::instance().getTexture(_textureID, _textureOffset);
+
+	_dstRect.x = static_cast<int>(transform->position.x + _relativePosX);
+	_dstRect.y = static_cast<int>(transform->position.y + _relativePosY);
+
+	updateSpatialBounds();
+}
+
+void ParticleEmitter::clear()
+{
+	_count = 0;
+	_emitAccumulator = 0.f;
+	_pendingBurst = 0;
+	_quads.clear();
+}
+
+void ParticleEmitter::simulate(float deltaTime, const Vector2& origin)
+{
+	PROFILE_FUNCTION();
+
+	int spawnCount = _pendingBurst;
+	_pendingBurst = 0;
+
+	if (_emitting && _settings.rate > 0.f)
+	{
+		_emitAccumulator += _settings.rate * deltaTime;
+		int emitted = static_cast<int>(_emitAccumulator);
+		_emitAccumulator -= emitted;
+		spawnCount += emitted;
+	}
+
+	integrate(deltaTime);
+	removeDead();
+	spawn(spawnCount, origin);
+	buildQuads();
+}
+
+void ParticleEmitter::spawn(int count, const Vector2& origin)
+{
+	count = SDL_min(count, _capacity - _count);
+	if (count <= 0)
+	{
+		return;
+	}
+
+	constexpr float DEGREES_TO_RADIANS = 3.14159265f / 180.f;
+	std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+	for (int i = _count; i < _count + count; i++)
+	{
+		float angle = (_settings.direction + (unit(_random) - 0.5f) * _settings.spread) * DEGREES_TO_RADIANS;
+		float speed = _settings.minSpeed + unit(_random) * (_settings.maxSpeed - _settings.minSpeed);
+		float lifetime = _settings.minLifetime + unit(_random) * (_settings.maxLifetime - _settings.minLifetime);
+
+		_positionX[i] = origin.x;
+		_positionY[i] = origin.y;
+		_velocityX[i] = std::cos(angle) * speed;
+		_velocityY[i] = std::sin(angle) * speed;
+		_life[i] = 0.f;
+		_lifeRate[i] = lifetime > 0.f ? 1.f / lifetime : 1.f / EPSILON;
+	}
+
+	_count += count;
+}
+
+void ParticleEmitter::integrate(float deltaTime)
+{
+	// One flat loop per attribute over plain float arrays, which the compiler can vectorize
+	const int count = _count;
+	const float damping = _settings.damping < 1.f ? std::pow(SDL_max(_settings.damping, 0.f), deltaTime) : 1.f;
+	const float gravityX = _settings.gravity.x * deltaTime;
+	const float gravityY = _settings.gravity.y * deltaTime;
+
+	float* velocityX = _velocityX.data();
+	float* velocityY = _velocityY.data();
+	for (int i = 0; i < count; i++)
+	{
+		velocityX[i] = velocityX[i] * damping + gravityX;
+		velocityY[i] = velocityY[i] * damping + gravityY;
+	}
+
+	float* positionX = _positionX.data();
+	float* positionY = _positionY.data();
+	for (int i = 0; i < count; i++)
+	{
+		positionX[i] += velocityX[i] * deltaTime;
+		positionY[i] += velocityY[i] * deltaTime;
+	}
+
+	float* life = _life.data();
+	const float* lifeRate = _lifeRate.data();
+	for (int i = 0; i < count; i++)
+	{
+		life[i] += lifeRate[i] * deltaTime;
+	}
+}
+
+void ParticleEmitter::removeDead()
+{
+	// Dead particles are replaced by the last live one, so the live ones stay packed at the front
+	for (int i = 0; i < _count;)
+	{
+		if (_life[i] < 1.f)
+		{
+			i++;
+			continue;
+		}
+
+		int last = --_count;
+		_positionX[i] = _positionX[last];
+		_positionY[i] = _positionY[last];
+		_velocityX[i] = _velocityX[last];
+		_velocityY[i] = _velocityY[last];
+		_life[i] = _life[last];
+		_lifeRate[i] = _lifeRate[last];
+	}
+}
+
+void ParticleEmitter::buildQuads()
+{
+	_quads.resize(_count);
+
+	if (_count == 0)
+	{
+		_dstRect.w = 0;
+		_dstRect.h = 0;
+		return;
+	}
+
+	SDL_Rect src = { _imageRect.x + _textureOffset.x, _imageRect.y + _textureOffset.y, _imageRect.w, _imageRect.h };
+	const SDL_Color& start = _settings.startColor;
+	const SDL_Color& end = _settings.endColor;
+
+	int minX = SDL_MAX_SINT32;
+	int minY = SDL_MAX_SINT32;
+	int maxX = SDL_MIN_SINT32;
+	int maxY = SDL_MIN_SINT32;
+
+	for (int i = 0; i < _count; i++)
+	{
+		float t = _life[i];
+		int size = static_cast<int>(_settings.startSize + (_settings.endSize - _settings.startSize) * t);
+
+		TexturedQuad& quad = _quads[i];
+		quad.texture = texture;
+		quad.srcRect = src;
+		quad.dstRect = { static_cast<int>(_positionX[i]) - size / 2, static_cast<int>(_positionY[i]) - size / 2, size, size };
+		quad.color = SDL_Color{
+			static_cast<Uint8>(start.r + (end.r - start.r) * t),
+			static_cast<Uint8>(start.g + (end.g - start.g) * t),
+			static_cast<Uint8>(start.b + (end.b - start.b) * t),
+			static_cast<Uint8>(start.a + (end.a - start.a) * t) };
+
+		minX = SDL_min(minX, quad.dstRect.x);
+		minY = SDL_min(minY, quad.dstRect.y);
+		maxX = SDL_max(maxX, quad.dstRect.x + size);
+		maxY = SDL_max(maxY, quad.dstRect.y + size);
+	}
+
+	// The dstRect wraps the particles so culling sees the whole effect, and the quads are relative to it
+	_dstRect = { minX, minY, maxX - minX, maxY - minY };
+
+	for (TexturedQuad& quad : _quads)
+	{
+		quad.dstRect.x -= minX;
+		quad.dstRect.y -= minY;
+	}
+}
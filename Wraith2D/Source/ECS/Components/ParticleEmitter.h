@@ -0,0 +1,173 @@
+#pragma once
+
+#include <SDL.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Renderable.h"
+#include "../../RenderLayer.h"
+
+/// <summary>
+/// Emits particles drawn from one texture image, without an entity per particle.
+/// Particles live in a fixed-capacity pool stored as one array per attribute, so the update loops run over
+/// contiguous floats, and every particle of an emitter is drawn with the same texture so they batch together.
+/// Particles are simulated in world coordinates, moving the emitter doesn't move the particles already emitted.
+/// </summary>
+class ParticleEmitter : public Renderable
+{
+public:
+	struct Settings
+	{
+		// Particles emitted per second while emitting
+		float rate = 100.f;
+
+		// Lifetime range, in seconds
+		float minLifetime = 0.5f;
+		float maxLifetime = 1.f;
+
+		// Initial speed range, in pixels per second
+		float minSpeed = 50.f;
+		float maxSpeed = 100.f;
+
+		// Emission direction and the spread around it, in degrees
+		float direction = -90.f;
+		float spread = 360.f;
+
+		// Constant acceleration, in pixels per second squared
+		Vector2 gravity;
+
+		// Fraction of the velocity kept after a second
+		float damping = 1.f;
+
+		// Size and color over the lifetime of a particle, interpolated from start to end
+		float startSize = 8.f;
+		float endSize = 8.f;
+		SDL_Color startColor = { 255, 255, 255, 255 };
+		SDL_Color endColor = { 255, 255, 255, 0 };
+	};
+
+	/// <summary>
+	/// Creates an emitter.
+	/// </summary>
+	/// <param name="renderLayer">The render layer</param>
+	/// <param name="depth">The depth inside the layer</param>
+	/// <param name="textureID">The ID of the texture</param>
+	/// <param name="srcX">X coord of the particle image inside the texture</param>
+	/// <param name="srcY">Y coord of the particle image inside the texture</param>
+	/// <param name="srcWidth">Width of the particle image</param>
+	/// <param name="srcHeight">Height of the particle image</param>
+	/// <param name="capacity">The maximum number of live particles, new particles are dropped while the pool is full</param>
+	/// <param name="settings">How particles are emitted and how they evolve</param>
+	ParticleEmitter(RenderLayer renderLayer, int depth, const std::string& textureID, int srcX, int srcY, int srcWidth, int srcHeight, int capacity, const Settings& settings, float relativePosX = 0.f, float relativePosY = 0.f);
+
+	void init() override;
+
+	/// <summary>
+	/// Particles are drawn as quads, so the emitter has no source rectangle.
+	/// </summary>
+	/// <returns>nullptr</returns>
+	virtual SDL_Rect* srcRect() override { return nullptr; }
+
+	/// <summary>
+	/// Returns the dstRect, the bounds of the live particles.
+	/// </summary>
+	/// <returns>The dstRect</returns>
+	virtual SDL_Rect* dstRect() override { return &_dstRect; }
+
+	/// <summary>
+	/// Returns a quad for every live particle, as of the last simulate call.
+	/// </summary>
+	/// <returns>The particle quads</returns>
+	virtual const std::vector<TexturedQuad>* quads() const override { return &_quads; }
+
+	/// <summary>
+	/// Starts or stops emitting particles at the settings' rate. Live particles keep going either way.
+	/// </summary>
+	/// <param name="emitting">Flag to emit or not</param>
+	inline void setEmitting(bool emitting) { _emitting = emitting; }
+
+	/// <summary>
+	/// Checks whether the emitter is emitting particles at the settings' rate.
+	/// </summary>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isEmitting() const { return _emitting; }
+
+	/// <summary>
+	/// Emits a burst of particles at the emitter position on the next simulate call.
+	/// </summary>
+	/// <param name="count">The number of particles</param>
+	inline void burst(int count) { _pendingBurst += SDL_max(count, 0); }
+
+	/// <summary>
+	/// Removes every live particle.
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Returns the settings.
+	/// </summary>
+	/// <returns>The settings</returns>
+	inline const Settings& getSettings() const { return _settings; }
+
+	/// <summary>
+	/// Replaces the settings. Live particles keep their lifetime and velocity.
+	/// </summary>
+	/// <param name="settings">The new settings</param>
+	inline void setSettings(const Settings& settings) { _settings = settings; }
+
+	/// <summary>
+	/// Returns the number of live particles.
+	/// </summary>
+	/// <returns>The number of live particles</returns>
+	inline int getParticleCount() const { return _count; }
+
+	/// <summary>
+	/// Returns the maximum number of live particles.
+	/// </summary>
+	/// <returns>The capacity</returns>
+	inline int getCapacity() const { return _capacity; }
+
+	/// <summary>
+	/// Sets the visible state of this emitter. Hidden emitters keep simulating.
+	/// </summary>
+	/// <param name="visible">The visible state</param>
+	inline void setVisible(bool visible) { this->visible = visible; }
+
+	/// <summary>
+	/// Emits, moves and ages the particles, removes the dead ones, then rebuilds the quads and the dstRect around them.
+	/// </summary>
+	/// <param name="deltaTime">The time since the last call, in seconds</param>
+	/// <param name="origin">Where new particles are emitted, in world coordinates</param>
+	void simulate(float deltaTime, const Vector2& origin);
+
+private:
+	Settings _settings;
+
+	std::string _textureID;
+	SDL_Rect _imageRect = { 0, 0, 0, 0 };
+
+	int _capacity = 0;
+	int _count = 0;
+
+	// Particle attributes, one array each. Live particles are packed at the front.
+	// Life goes from 0 to 1 over the lifetime of a particle, at its life rate per second
+	std::vector<float> _positionX;
+	std::vector<float> _positionY;
+	std::vector<float> _velocityX;
+	std::vector<float> _velocityY;
+	std::vector<float> _life;
+	std::vector<float> _lifeRate;
+
+	bool _emitting = true;
+	float _emitAccumulator = 0.f;
+	int _pendingBurst = 0;
+	std::mt19937 _random;
+
+	std::vector<TexturedQuad> _quads;
+
+	void spawn(int count, const Vector2& origin);
+	void integrate(float deltaTime);
+	void removeDead();
+	void buildQuads();
+};
@@ -1,10 +1,98 @@
 #include "Renderable.h"
+#include <cmath>
+#include <cstring>
 #include "../../Engine.h"
 
-void Renderable::makeDstRelativeToCamera()
+uint64_t Renderable::s_nextInsertionIndex = 0u;
+
+Renderable::~Renderable()
+{
+	if (_spatialHandle != SpatialGrid::INVALID_HANDLE)
+	{
+		Engine::instance().spatialGrid().remove(_spatialHandle);
+	}
+
+	if (_staticSignature != 0u && Engine::instance().isLayerStatic(renderLayer))
+	{
+		Engine::instance().invalidateStaticLayer(renderLayer, _staticBounds);
+	}
+}
+
+void Renderable::updateSpatialBounds()
+{
+	SDL_Rect bounds = _dstRect;
+
+	// A rotated rect always fits in the square around its diagonal, whatever the angle
+	if (transform != nullptr && transform->rotation != 0.f)
+	{
+		int diagonal = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(bounds.w) * bounds.w + static_cast<float>(bounds.h) * bounds.h)));
+		bounds.x -= (diagonal - bounds.w) / 2 + 1;
+		bounds.y -= (diagonal - bounds.h) / 2 + 1;
+		bounds.w = diagonal + 2;
+		bounds.h = diagonal + 2;
+	}
+
+	SpatialGrid& grid = Engine::instance().spatialGrid();
+	if (_spatialHandle == SpatialGrid::INVALID_HANDLE)
+	{
+		_spatialHandle = grid.insert(this, bounds);
+	}
+	else
+	{
+		grid.update(_spatialHandle, bounds);
+	}
+
+	if (Engine::instance().isLayerStatic(renderLayer))
+	{
+		uint64_t signature = drawSignature(bounds);
+		if (signature != _staticSignature)
+		{
+			// Redraw both where it was and where it is now
+			if (_staticSignature != 0u)
+			{
+				Engine::instance().invalidateStaticLayer(renderLayer, _staticBounds);
+			}
+
+			Engine::instance().invalidateStaticLayer(renderLayer, bounds);
+			_staticSignature = signature;
+			_staticBounds = bounds;
+		}
+	}
+}
+
+uint64_t Renderable::drawSignature(const SDL_Rect& bounds)
 {
-	// Make final destination relative to camera
-	SDL_Rect camera = Engine::instance().getCamera();
-	_dstRect.x -= camera.x;
-	_dstRect.y -= camera.y;
+	// FNV-1a over everything that affects how this Renderable is drawn
+	uint64_t hash = 14695981039346656037ull;
+	auto mix = [&hash](uint64_t value) { hash = (hash ^ value) * 1099511628211ull; };
+
+	mix(static_cast<uint32_t>(bounds.x));
+	mix(static_cast<uint32_t>(bounds.y));
+	mix(static_cast<uint32_t>(bounds.w));
+	mix(static_cast<uint32_t>(bounds.h));
+	mix(reinterpret_cast<uintptr_t>(texture));
+	mix(_contentVersion);
+	mix(static_cast<uint32_t>(flip));
+	mix(static_cast<uint32_t>(depth));
+	mix(visible ? 1u : 0u);
+	mix(static_cast<uint32_t>(_tint.r) << 24 | _tint.g << 16 | _tint.b << 8 | _tint.a);
+
+	SDL_Rect* src = srcRect();
+	if (src != nullptr)
+	{
+		mix(static_cast<uint32_t>(src->x + _textureOffset.x));
+		mix(static_cast<uint32_t>(src->y + _textureOffset.y));
+		mix(static_cast<uint32_t>(src->w));
+		mix(static_cast<uint32_t>(src->h));
+	}
+
+	if (transform != nullptr)
+	{
+		uint32_t rotationBits;
+		std::memcpy(&rotationBits, &transform->rotation, sizeof(rotationBits));
+		mix(rotationBits);
+	}
+
+	// Zero means nothing was drawn yet
+	return hash != 0u ? hash : 1u;
 }
\ No newline at end of file
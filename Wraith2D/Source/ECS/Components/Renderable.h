@@ -4,6 +4,8 @@
 #include "../ECS.h"
 #include "Transform.h"
 #include "../../RenderLayer.h"
+#include "../../Rendering/SpatialGrid.h"
+#include "../../Rendering/RenderQueue.h"
 
 class Renderable : public Component
 {
@@ -13,12 +15,10 @@ public:
 		, depth(depth)
 		, _relativePosX(relativePosX)
 		, _relativePosY(relativePosY)
+		, _insertionIndex(s_nextInsertionIndex++)
 	{}
 
-	~Renderable()
-	{
-
-	}
+	~Renderable();
 
 	virtual void init() override 
 	{
@@ -28,6 +28,13 @@ public:
 	virtual SDL_Rect* srcRect() = 0;
 	virtual SDL_Rect* dstRect() = 0;
 
+	/// <summary>
+	/// Returns the quads of a Renderable drawn in several parts, like text drawn from a glyph atlas.
+	/// Renderables drawn as a single texture return nullptr.
+	/// </summary>
+	/// <returns>The quads, with dst rects relative to the dstRect, or nullptr</returns>
+	virtual const std::vector<TexturedQuad>* quads() const { return nullptr; }
+
 	/// <summary>
 	/// Get the position offset relative to the Transform.
 	/// </summary>
@@ -45,9 +52,10 @@ public:
 	}
 
 	/// <summary>
-	/// Converts the dst coordinates to make them relative to the game camera.
+	/// Updates the world bounds of this Renderable in the spatial grid used for camera culling,
+	/// and invalidates the cached area of a static layer when anything about how it is drawn changed.
 	/// </summary>
-	void makeDstRelativeToCamera();
+	void updateSpatialBounds();
 	
 	/// <summary>
 	/// Returns the texture of this Renderable.
@@ -55,6 +63,55 @@ public:
 	/// <returns>A pointer to the texture</returns>
 	inline SDL_Texture* getTexture() { return texture; }
 
+	/// <summary>
+	/// Returns the position of this Renderable's image inside its texture, which is only non-zero for atlas images.
+	/// The srcRect stays relative to the image and is offset by this when drawing.
+	/// </summary>
+	/// <returns>The offset of the image inside the texture</returns>
+	inline SDL_Point getTextureOffset() const { return _textureOffset; }
+
+	/// <summary>
+	/// Sets the color this Renderable is multiplied with when drawn, applied as the texture color and alpha mod.
+	/// </summary>
+	/// <param name="tint">The tint, white for none</param>
+	inline void setTint(SDL_Color tint) { _tint = tint; }
+
+	/// <summary>
+	/// Returns the tint of this Renderable.
+	/// </summary>
+	/// <returns>The tint</returns>
+	inline const SDL_Color& getTint() const { return _tint; }
+
+	/// <summary>
+	/// Sets the opacity of this Renderable. Only affects textures with an alpha channel.
+	/// </summary>
+	/// <param name="alpha">The opacity, from 0 (invisible) to 255 (opaque)</param>
+	inline void setAlpha(Uint8 alpha) { _tint.a = alpha; }
+
+	/// <summary>
+	/// Returns the opacity of this Renderable.
+	/// </summary>
+	/// <returns>The opacity</returns>
+	inline Uint8 getAlpha() const { return _tint.a; }
+
+	/// <summary>
+	/// Declares the part of this Renderable's image that has no transparent pixels, so draws behind it can be skipped.
+	/// Only used while it is drawn unrotated and without transparency. Renderables drawn as quads ignore it.
+	/// </summary>
+	/// <param name="opaqueRect">The opaque rect in image pixels, relative to the top left corner of the srcRect</param>
+	inline void setOpaqueRect(const SDL_Rect& opaqueRect) { _opaqueRect = opaqueRect; }
+
+	/// <summary>
+	/// Removes the opaque rect, for images that change to one with transparent pixels.
+	/// </summary>
+	inline void clearOpaqueRect() { _opaqueRect = SDL_Rect{ 0, 0, 0, 0 }; }
+
+	/// <summary>
+	/// Returns the opaque rect of this Renderable.
+	/// </summary>
+	/// <returns>The opaque rect in image pixels, empty if none was declared</returns>
+	inline const SDL_Rect& getOpaqueRect() const { return _opaqueRect; }
+
 	/// <summary>
 	/// Returns the Render Layer of this Renderable.
 	/// </summary>
@@ -93,9 +150,37 @@ protected:
 	float _relativePosY = 0.f;
 
 	SDL_Texture* texture = nullptr;
+	SDL_Point _textureOffset = { 0, 0 };
+	SDL_Color _tint = { 255, 255, 255, 255 };
+	SDL_Rect _opaqueRect = { 0, 0, 0, 0 };
 	RenderLayer renderLayer = RenderLayer::Background;
 	SDL_RendererFlip flip = SDL_FLIP_NONE;
 	int depth = 0;
 	bool visible = true;
 	Transform* transform = nullptr;
+
+	/// <summary>
+	/// Flags that the texture content changed even if the texture pointer didn't, so cached static layers redraw it.
+	/// </summary>
+	inline void markContentChanged() { _contentVersion++; }
+
+private:
+	friend class RenderSystem;
+
+	uint32_t _spatialHandle = SpatialGrid::INVALID_HANDLE;
+
+	// Creation order of the renderables, the tiebreak between equal sort keys and the draw order of layers that aren't sorted
+	static uint64_t s_nextInsertionIndex;
+	uint64_t _insertionIndex = 0u;
+
+	// Position in the last Y sort and the sort pass it is from, used to start the next sort from the last order
+	uint32_t _sortRank = 0u;
+	uint32_t _sortPass = 0u;
+
+	// What this Renderable looked like when its static layer was last invalidated
+	uint64_t _staticSignature = 0u;
+	SDL_Rect _staticBounds = { 0, 0, 0, 0 };
+	uint32_t _contentVersion = 0u;
+
+	uint64_t drawSignature(const SDL_Rect& bounds);
 };
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "Shape.h"
+
+#include <cmath>
+#include <cstdlib>
+
+Shape::Shape(RenderLayer renderLayer, int depth, ShapeType type, float width, float height, SDL_Color color, float thickness, float relativePosX, float relativePosY)
+	: Renderable(renderLayer, depth, relativePosX, relativePosY)
+	, _type(type)
+	, _width(width)
+	, _height(height)
+	, _thickness(thickness)
+{
+	// Shapes have no texture, their color is the tint the fills are drawn with
+	_tint = color;
+}
+
+void Shape::init()
+{
+	transform = &entity->getComponent<Transform>();
+
+	Vector2 origin(transform->position.x + _relativePosX * transform->scale.x, transform->position.y + _relativePosY * transform->scale.y);
+	place(origin, transform->scale);
+}
+
+void Shape::setSize(float width, float height)
+{
+	if (width != _width || height != _height)
+	{
+		_width = width;
+		_height = height;
+		_dirty = true;
+	}
+}
+
+void Shape::setThickness(float thickness)
+{
+	if (thickness != _thickness)
+	{
+		_thickness = thickness;
+		_dirty = true;
+	}
+}
+
+void Shape::setType(ShapeType type)
+{
+	if (type != _type)
+	{
+		_type = type;
+		_dirty = true;
+	}
+}
+
+void Shape::place(const Vector2& position, const Vector2& scale)
+{
+	if (_dirty || scale != _builtScale)
+	{
+		build(scale);
+	}
+
+	_dstRect.x = static_cast<int>(std::round(position.x)) + _boundsOffset.x;
+	_dstRect.y = static_cast<int>(std::round(position.y)) + _boundsOffset.y;
+}
+
+void Shape::build(const Vector2& scale)
+{
+	_quads.clear();
+
+	int thickness = SDL_max(1, static_cast<int>(std::round(_thickness)));
+
+	if (_type == ShapeType::Line)
+	{
+		buildLine(_width * scale.x, _height * scale.y, thickness);
+	}
+	else
+	{
+		int width = static_cast<int>(std::round(std::fabs(_width * scale.x)));
+		int height = static_cast<int>(std::round(std::fabs(_height * scale.y)));
+
+		if (width > 0 && height > 0)
+		{
+			if (_type == ShapeType::Rect || thickness * 2 >= width || thickness * 2 >= height)
+			{
+				addQuad(0, 0, width, height);
+			}
+			else
+			{
+				// The sides don't overlap the corners, so translucent outlines blend evenly
+				addQuad(0, 0, width, thickness);
+				addQuad(0, height - thickness, width, thickness);
+				addQuad(0, thickness, thickness, height - thickness * 2);
+				addQuad(width - thickness, thickness, thickness, height - thickness * 2);
+			}
+		}
+	}
+
+	// The dstRect is the union of the quads, which are then made relative to it
+	int left = 0;
+	int top = 0;
+	int right = 0;
+	int bottom = 0;
+	if (!_quads.empty())
+	{
+		left = _quads[0].dstRect.x;
+		top = _quads[0].dstRect.y;
+		right = left + _quads[0].dstRect.w;
+		bottom = top + _quads[0].dstRect.h;
+
+		for (const TexturedQuad& quad : _quads)
+		{
+			left = SDL_min(left, quad.dstRect.x);
+			top = SDL_min(top, quad.dstRect.y);
+			right = SDL_max(right, quad.dstRect.x + quad.dstRect.w);
+			bottom = SDL_max(bottom, quad.dstRect.y + quad.dstRect.h);
+		}
+
+		for (TexturedQuad& quad : _quads)
+		{
+			quad.dstRect.x -= left;
+			quad.dstRect.y -= top;
+		}
+	}
+
+	_boundsOffset = SDL_Point{ left, top };
+	_dstRect.w = right - left;
+	_dstRect.h = bottom - top;
+
+	_builtScale = scale;
+	_dirty = false;
+
+	// The quads changed without a texture to tell, so cached static layers have to redraw the shape
+	markContentChanged();
+}
+
+void Shape::buildLine(float endX, float endY, int thickness)
+{
+	int x = static_cast<int>(std::round(endX));
+	int y = static_cast<int>(std::round(endY));
+
+	bool steep = std::abs(y) > std::abs(x);
+	int major = steep ? std::abs(y) : std::abs(x);
+	int minor = steep ? std::abs(x) : std::abs(y);
+	bool majorMirrored = (steep ? y : x) < 0;
+	bool minorMirrored = (steep ? x : y) < 0;
+
+	int before = thickness / 2;
+	int after = thickness - 1 - before;
+
+	// A staircase of spans, one per step on the minor axis like Bresenham's, each as thick as the line across it.
+	// Axis aligned lines are a single span
+	int steps = SDL_min(minor + 1, MAX_LINE_STEPS);
+	for (int i = 0; i < steps; i++)
+	{
+		int majorBegin = i * (major + 1) / steps;
+		int majorEnd = (i + 1) * (major + 1) / steps;
+		int minorBegin = i * (minor + 1) / steps - before;
+		int minorEnd = (i + 1) * (minor + 1) / steps + after;
+
+		// Only the ends are thickened along the line, so the spans don't overlap and translucent lines blend evenly
+		if (i == 0)
+		{
+			majorBegin -= before;
+		}
+		if (i == steps - 1)
+		{
+			majorEnd += after;
+		}
+
+		// Mirrored into the direction of the line, pixels [begin, end) become [1 - end, 1 - begin)
+		if (majorMirrored)
+		{
+			int begin = 1 - majorEnd;
+			majorEnd = 1 - majorBegin;
+			majorBegin = begin;
+		}
+		if (minorMirrored)
+		{
+			int begin = 1 - minorEnd;
+			minorEnd = 1 - minorBegin;
+			minorBegin = begin;
+		}
+
+		if (steep)
+		{
+			addQuad(minorBegin, majorBegin, minorEnd - minorBegin, majorEnd - majorBegin);
+		}
+		else
+		{
+			addQuad(majorBegin, minorBegin, majorEnd - majorBegin, minorEnd - minorBegin);
+		}
+	}
+}
+
+void Shape::addQuad(int x, int y, int w, int h)
+{
+	TexturedQuad quad;
+	quad.dstRect = SDL_Rect{ x, y, w, h };
+	_quads.emplace_back(quad);
+}
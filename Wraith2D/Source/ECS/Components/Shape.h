@@ -0,0 +1,150 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+#include "Renderable.h"
+#include "../../RenderLayer.h"
+
+enum class ShapeType
+{
+	// A filled rectangle
+	Rect,
+
+	// The border of a rectangle, drawn inside its bounds
+	Outline,
+
+	// A line from the shape position to the end point given by its size
+	Line
+};
+
+/// <summary>
+/// A solid colored rect, outline or line, like a health bar or a selection box. Shapes have no texture,
+/// they are drawn as fill rects, and every shape of the same color in a layer and depth is drawn with a single call.
+/// Shapes follow the position and scale of their Transform, but not its rotation.
+/// </summary>
+class Shape : public Renderable
+{
+public:
+	/// <summary>
+	/// Creates a shape.
+	/// </summary>
+	/// <param name="renderLayer">The render layer</param>
+	/// <param name="depth">The depth inside the layer</param>
+	/// <param name="type">The type of shape</param>
+	/// <param name="width">The width, or for lines the horizontal offset of the end point, which may be negative</param>
+	/// <param name="height">The height, or for lines the vertical offset of the end point, which may be negative</param>
+	/// <param name="color">The fill color</param>
+	/// <param name="thickness">The thickness of outlines and lines, in pixels</param>
+	Shape(RenderLayer renderLayer, int depth, ShapeType type, float width, float height, SDL_Color color, float thickness = 1.f, float relativePosX = 0.f, float relativePosY = 0.f);
+
+	void init() override;
+
+	/// <summary>
+	/// Shapes are drawn as fill rects, so they have no source rectangle.
+	/// </summary>
+	/// <returns>nullptr</returns>
+	virtual SDL_Rect* srcRect() override { return nullptr; }
+
+	/// <summary>
+	/// Returns the dstRect, the bounds of the shape.
+	/// </summary>
+	/// <returns>The dstRect</returns>
+	virtual SDL_Rect* dstRect() override { return &_dstRect; }
+
+	/// <summary>
+	/// Returns the fill rects the shape is made of, as of the last place call.
+	/// </summary>
+	/// <returns>The quads, without textures</returns>
+	virtual const std::vector<TexturedQuad>* quads() const override { return &_quads; }
+
+	/// <summary>
+	/// Sets the size. For lines this is the end point relative to the start.
+	/// </summary>
+	/// <param name="width">The new width</param>
+	/// <param name="height">The new height</param>
+	void setSize(float width, float height);
+
+	/// <summary>
+	/// Returns the width, or for lines the horizontal offset of the end point.
+	/// </summary>
+	/// <returns>The width</returns>
+	inline float getWidth() const { return _width; }
+
+	/// <summary>
+	/// Returns the height, or for lines the vertical offset of the end point.
+	/// </summary>
+	/// <returns>The height</returns>
+	inline float getHeight() const { return _height; }
+
+	/// <summary>
+	/// Sets the thickness of outlines and lines.
+	/// </summary>
+	/// <param name="thickness">The new thickness, in pixels</param>
+	void setThickness(float thickness);
+
+	/// <summary>
+	/// Returns the thickness of outlines and lines.
+	/// </summary>
+	/// <returns>The thickness</returns>
+	inline float getThickness() const { return _thickness; }
+
+	/// <summary>
+	/// Changes the type of shape.
+	/// </summary>
+	/// <param name="type">The new type</param>
+	void setType(ShapeType type);
+
+	/// <summary>
+	/// Returns the type of shape.
+	/// </summary>
+	/// <returns>The type</returns>
+	inline ShapeType getType() const { return _type; }
+
+	/// <summary>
+	/// Sets the fill color. Shapes are drawn in their tint, so this costs nothing and can change every frame.
+	/// </summary>
+	/// <param name="color">The new color</param>
+	inline void setColor(SDL_Color color) { setTint(color); }
+
+	/// <summary>
+	/// Returns the fill color.
+	/// </summary>
+	/// <returns>The color</returns>
+	inline const SDL_Color& getColor() const { return getTint(); }
+
+	/// <summary>
+	/// Sets the visible state of this shape.
+	/// </summary>
+	/// <param name="visible">The visible state</param>
+	inline void setVisible(bool visible) { this->visible = visible; }
+
+	/// <summary>
+	/// Moves the shape, rebuilding its fill rects when its size, thickness, type or scale changed.
+	/// </summary>
+	/// <param name="position">The position of the shape, in world coordinates</param>
+	/// <param name="scale">The scale of the Transform, applied to the size but not the thickness</param>
+	void place(const Vector2& position, const Vector2& scale);
+
+private:
+	// Lines steeper or longer than this many pixels on their minor axis are drawn with coarser steps
+	static constexpr int MAX_LINE_STEPS = 256;
+
+	ShapeType _type;
+	float _width;
+	float _height;
+	float _thickness;
+
+	// Set when the fill rects have to be rebuilt before the next draw
+	bool _dirty = true;
+	Vector2 _builtScale = Vector2(1.f, 1.f);
+
+	// From the shape position to the top left corner of its bounds, only non-zero for lines
+	SDL_Point _boundsOffset = { 0, 0 };
+
+	std::vector<TexturedQuad> _quads;
+
+	void build(const Vector2& scale);
+	void buildLine(float endX, float endY, int thickness);
+	void addQuad(int x, int y, int w, int h);
+};
@@ -4,7 +4,7 @@
 void Sprite::init()
 {
 	transform = &entity->getComponent<Transform>();
-	texture = AssetManager::instance().getTexture(_textureID);
+	texture = AssetManager::instance().getTexture(_textureID, _textureOffset);
 
 	_srcRect.x = _srcX;
 	_srcRect.y = _srcY;
@@ -16,5 +16,5 @@ void Sprite::init()
 	_dstRect.w = static_cast<int>(_dstWidth * transform->scale.x);
 	_dstRect.h = static_cast<int>(_dstHeight * transform->scale.y);
 
-	makeDstRelativeToCamera();
+	updateSpatialBounds();
 }
\ No newline at end of file
@@ -69,6 +69,12 @@ public:
 		return &_dstRect;
 	}
 
+	/// <summary>
+	/// Sets the dstRect without going through the virtual accessor, for systems placing many sprites.
+	/// </summary>
+	/// <param name="rect">The new dstRect in world coordinates</param>
+	inline void setDstRect(const SDL_Rect& rect) { _dstRect = rect; }
+
 	/// <summary>
 	/// Sets the texture for this Sprite.
 	/// </summary>
@@ -76,7 +82,7 @@ public:
 	inline void setTexture(const std::string& newTextureID)
 	{
 		_textureID = newTextureID;
-		texture = AssetManager::instance().getTexture(_textureID);
+		texture = AssetManager::instance().getTexture(_textureID, _textureOffset);
 	}
 
 	/// <summary>
@@ -3,6 +3,7 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 #include <string>
+#include <vector>
 
 #include "Renderable.h"
 #include "../../Engine.h"
@@ -16,9 +17,10 @@ public:
 		: Renderable(RenderLayer::UI, depth, relativePosX, relativePosY)
 		, _fontID(fontID)
 		, _text(text)
-		, _textColor(color)
 		, _wrapLength(wrapLength)
 	{
+		// Text is rasterized in white, its color is the tint it is drawn with
+		_tint = color;
 		setText(this->_fontID, this->_text);
 	}
 
@@ -27,14 +29,14 @@ public:
 		transform = &entity->getComponent<Transform>();
 		_dstRect.x = static_cast<int>(transform->position.x + _relativePosX);
 		_dstRect.y = static_cast<int>(transform->position.y + _relativePosY);
-		makeDstRelativeToCamera();
+		updateSpatialBounds();
 	}
 
 	~Text()
 	{ 
 		if (texture != nullptr)
 		{
-			SDL_DestroyTexture(texture);
+			AssetManager::instance().textTextureCache().release(texture);
 		}
 	}
 
@@ -45,37 +47,83 @@ public:
 	/// <param name="text">The new text</param>
 	void setText(std::string fontID, std::string text)
 	{
-		this->_fontID = fontID;
-		this->_text = text;
-
-		if (texture != nullptr)
+		if (_useGlyphs)
 		{
-			SDL_DestroyTexture(texture);
+			// Laid out from the glyph atlas, so nothing is rasterized and unchanged text costs nothing
+			if (fontID != this->_fontID || text != this->_text)
+			{
+				this->_fontID = fontID;
+				this->_text = text;
+				layoutGlyphs();
+			}
+
+			return;
 		}
 
-		SDL_Surface* surf = TTF_RenderText_Blended_Wrapped(AssetManager::instance().getFont(fontID), text.c_str(), _textColor, _wrapLength);
-		texture = SDL_CreateTextureFromSurface(Engine::instance().getRenderer(), surf);
-		SDL_FreeSurface(surf);
+		if (texture != nullptr && fontID == this->_fontID && text == this->_text)
+		{
+			return;
+		}
 
-		SDL_QueryTexture(texture, nullptr, nullptr, &_dstRect.w, &_dstRect.h);
+		this->_fontID = fontID;
+		this->_text = text;
+		acquireTexture();
 	}
 
 	/// <summary>
-	/// Sets the text color.
+	/// Sets the text color. The text is tinted when drawn, so this costs nothing and can change every frame.
 	/// </summary>
 	/// <param name="newColor">The new text color</param>
-	void setTextColor(SDL_Color newColor)
+	inline void setTextColor(SDL_Color newColor)
 	{
-		if (texture != nullptr)
+		setTint(newColor);
+	}
+
+	/// <summary>
+	/// Switches between drawing the text from its own texture, rasterized on every change,
+	/// and laying it out from the font's glyph atlas. Use the glyph atlas for text that changes often.
+	/// </summary>
+	/// <param name="useGlyphs">Flag to draw from the glyph atlas or not</param>
+	void setGlyphRendering(bool useGlyphs)
+	{
+		if (useGlyphs == _useGlyphs)
 		{
-			SDL_DestroyTexture(texture);
+			return;
 		}
 
-		SDL_Surface* surf = TTF_RenderText_Blended(AssetManager::instance().getFont(_fontID), _text.c_str(), newColor);
-		texture = SDL_CreateTextureFromSurface(Engine::instance().getRenderer(), surf);
-		SDL_FreeSurface(surf);
+		_useGlyphs = useGlyphs;
+
+		if (_useGlyphs)
+		{
+			if (texture != nullptr)
+			{
+				AssetManager::instance().textTextureCache().release(texture);
+				texture = nullptr;
+			}
 
-		SDL_QueryTexture(texture, nullptr, nullptr, &_dstRect.w, &_dstRect.h);
+			layoutGlyphs();
+		}
+		else
+		{
+			_quads.clear();
+			_quads.shrink_to_fit();
+			setText(_fontID, _text);
+		}
+	}
+
+	/// <summary>
+	/// Checks whether the text is drawn from the glyph atlas.
+	/// </summary>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isGlyphRendering() const { return _useGlyphs; }
+
+	/// <summary>
+	/// Returns the glyph quads when drawing from the glyph atlas.
+	/// </summary>
+	/// <returns>The glyph quads, or nullptr if the text has its own texture</returns>
+	virtual const std::vector<TexturedQuad>* quads() const override
+	{
+		return _useGlyphs ? &_quads : nullptr;
 	}
 
 	/// <summary>
@@ -112,7 +160,7 @@ public:
 	/// Returns the text color.
 	/// </summary>
 	/// <returns>The text color</returns>
-	inline const SDL_Color& getTextColor() const { return _textColor; }
+	inline const SDL_Color& getTextColor() const { return getTint(); }
 
 	/// <summary>
 	/// Returns the wrap length in pixels.
@@ -123,6 +171,36 @@ public:
 private:
 	std::string _fontID;
 	std::string _text;
-	SDL_Color _textColor;
 	unsigned int _wrapLength;
+
+	bool _useGlyphs = false;
+	std::vector<TexturedQuad> _quads;
+
+	void acquireTexture()
+	{
+		// Acquire before releasing, so the texture isn't destroyed and rasterized again when the content is the same
+		TextTextureCache& cache = AssetManager::instance().textTextureCache();
+		SDL_Texture* previous = texture;
+		texture = cache.acquire(_fontID, _text, _wrapLength, _dstRect.w, _dstRect.h);
+
+		if (previous != nullptr)
+		{
+			cache.release(previous);
+		}
+
+		markContentChanged();
+	}
+
+	void layoutGlyphs()
+	{
+		GlyphAtlas* glyphAtlas = AssetManager::instance().getGlyphAtlas(_fontID);
+		if (glyphAtlas == nullptr)
+		{
+			_quads.clear();
+			return;
+		}
+
+		glyphAtlas->layout(_text, _wrapLength, _quads, _dstRect.w, _dstRect.h);
+		markContentChanged();
+	}
 };
\ No newline at end of file
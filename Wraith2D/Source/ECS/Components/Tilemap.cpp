@@ -0,0 +1,395 @@
+#include "Tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "../../Engine.h"
+#include "../../AssetManager.h"
+#include "../../Profiling/Profiler.h"
+
+Tilemap::Tilemap(RenderLayer renderLayer, int depth, const std::string& tilesetID, int tileWidth, int tileHeight, int columns, int rows, float relativePosX, float relativePosY)
+	: Renderable(renderLayer, depth, relativePosX, relativePosY)
+	, _tilesetID(tilesetID)
+	, _tileWidth(SDL_max(tileWidth, 1))
+	, _tileHeight(SDL_max(tileHeight, 1))
+	, _columns(SDL_max(columns, 0))
+	, _rows(SDL_max(rows, 0))
+{
+	_tiles.assign(static_cast<std::size_t>(_columns) * _rows, EMPTY_TILE);
+
+	_chunkColumns = (_columns + CHUNK_TILES - 1) / CHUNK_TILES;
+	_chunkRows = (_rows + CHUNK_TILES - 1) / CHUNK_TILES;
+	_chunks.resize(static_cast<std::size_t>(_chunkColumns) * _chunkRows);
+}
+
+Tilemap::~Tilemap()
+{
+	releaseChunkTextures();
+}
+
+void Tilemap::init()
+{
+	transform = &entity->getComponent<Transform>();
+	setTileset(_tilesetID);
+
+	_dstRect.x = static_cast<int>(transform->position.x + _relativePosX);
+	_dstRect.y = static_cast<int>(transform->position.y + _relativePosY);
+	_dstRect.w = static_cast<int>(_columns * _tileWidth * transform->scale.x);
+	_dstRect.h = static_cast<int>(_rows * _tileHeight * transform->scale.y);
+
+	updateSpatialBounds();
+}
+
+void Tilemap::setTile(int column, int row, uint16_t tile)
+{
+	if (column < 0 || row < 0 || column >= _columns || row >= _rows)
+	{
+		return;
+	}
+
+	uint16_t& current = _tiles[static_cast<std::size_t>(row) * _columns + column];
+	if (current == tile)
+	{
+		return;
+	}
+
+	Chunk& chunk = chunkOf(column, row);
+	chunk.filledTiles += (tile != EMPTY_TILE ? 1 : 0) - (current != EMPTY_TILE ? 1 : 0);
+	chunk.dirty = true;
+
+	current = tile;
+	markContentChanged();
+}
+
+uint16_t Tilemap::getTile(int column, int row) const
+{
+	if (column < 0 || row < 0 || column >= _columns || row >= _rows)
+	{
+		return EMPTY_TILE;
+	}
+
+	return _tiles[static_cast<std::size_t>(row) * _columns + column];
+}
+
+void Tilemap::setTiles(const std::vector<uint16_t>& tiles)
+{
+	if (tiles.size() != _tiles.size())
+	{
+		std::cerr << "Tilemap expects " << _tiles.size() << " tiles, got " << tiles.size() << std::endl;
+		return;
+	}
+
+	_tiles = tiles;
+	countFilledTiles();
+	invalidateChunks();
+}
+
+void Tilemap::fill(uint16_t tile)
+{
+	std::fill(_tiles.begin(), _tiles.end(), tile);
+	countFilledTiles();
+	invalidateChunks();
+}
+
+void Tilemap::setTileset(const std::string& tilesetID)
+{
+	_tilesetID = tilesetID;
+
+	// The tileset may be packed into an atlas, so tiles are offset by its position in there
+	SDL_Rect region = { 0, 0, 0, 0 };
+	texture = AssetManager::instance().getTextureRegion(_tilesetID, region);
+	_textureOffset = SDL_Point{ region.x, region.y };
+	_tilesetColumns = region.w / _tileWidth;
+
+	invalidateChunks();
+}
+
+void Tilemap::invalidateChunks()
+{
+	for (auto& chunk : _chunks)
+	{
+		chunk.dirty = true;
+	}
+
+	markContentChanged();
+}
+
+void Tilemap::updateChunks(SDL_Renderer* renderer, const SDL_Rect* views, std::size_t viewCount, const Vector2& scale)
+{
+	PROFILE_FUNCTION();
+
+	_quads.clear();
+	_frame++;
+
+	if (texture == nullptr || _tilesetColumns == 0 || _chunks.empty() || scale.x <= 0.f || scale.y <= 0.f)
+	{
+		return;
+	}
+
+	bool canBake = SDL_RenderTargetSupported(renderer);
+	bool baked = false;
+
+	// Only taken once a chunk needs baking, and held until the render target is restored
+	std::unique_lock<std::recursive_mutex> rendererLock;
+
+	for (std::size_t i = 0; i < viewCount; i++)
+	{
+		int minColumn, minRow, maxColumn, maxRow;
+		if (!chunkRange(views[i], scale, minColumn, minRow, maxColumn, maxRow))
+		{
+			continue;
+		}
+
+		for (int chunkRow = minRow; chunkRow <= maxRow; chunkRow++)
+		{
+			for (int chunkColumn = minColumn; chunkColumn <= maxColumn; chunkColumn++)
+			{
+				Chunk& chunk = _chunks[static_cast<std::size_t>(chunkRow) * _chunkColumns + chunkColumn];
+
+				// Views can overlap, every chunk is only added once
+				if (chunk.lastVisibleFrame == _frame)
+				{
+					continue;
+				}
+				chunk.lastVisibleFrame = _frame;
+
+				if (chunk.filledTiles == 0)
+				{
+					continue;
+				}
+
+				if (!canBake)
+				{
+					addTileQuads(chunkColumn, chunkRow, scale);
+					continue;
+				}
+
+				if (chunk.dirty || chunk.texture == nullptr)
+				{
+					if (!rendererLock.owns_lock())
+					{
+						rendererLock = Engine::instance().lockRenderer();
+					}
+
+					if (!bakeChunk(renderer, chunkColumn, chunkRow))
+					{
+						addTileQuads(chunkColumn, chunkRow, scale);
+						continue;
+					}
+
+					baked = true;
+				}
+
+				addChunkQuad(chunk, chunkColumn, chunkRow, scale);
+			}
+		}
+	}
+
+	if (baked)
+	{
+		SDL_SetRenderTarget(renderer, nullptr);
+	}
+}
+
+bool Tilemap::chunkRange(const SDL_Rect& view, const Vector2& scale, int& minColumn, int& minRow, int& maxColumn, int& maxRow) const
+{
+	// The view relative to the map, in unscaled map pixels
+	float chunkWidth = static_cast<float>(CHUNK_TILES * _tileWidth);
+	float chunkHeight = static_cast<float>(CHUNK_TILES * _tileHeight);
+	float left = (view.x - _dstRect.x) / scale.x;
+	float top = (view.y - _dstRect.y) / scale.y;
+	float right = (view.x + view.w - _dstRect.x) / scale.x;
+	float bottom = (view.y + view.h - _dstRect.y) / scale.y;
+
+	if (right <= 0.f || bottom <= 0.f)
+	{
+		return false;
+	}
+
+	minColumn = SDL_max(static_cast<int>(left / chunkWidth), 0);
+	minRow = SDL_max(static_cast<int>(top / chunkHeight), 0);
+	maxColumn = SDL_min(static_cast<int>(std::ceil(right / chunkWidth)) - 1, _chunkColumns - 1);
+	maxRow = SDL_min(static_cast<int>(std::ceil(bottom / chunkHeight)) - 1, _chunkRows - 1);
+
+	return minColumn <= maxColumn && minRow <= maxRow;
+}
+
+void Tilemap::addChunkQuad(const Chunk& chunk, int chunkColumn, int chunkRow, const Vector2& scale)
+{
+	int firstColumn = chunkColumn * CHUNK_TILES;
+	int firstRow = chunkRow * CHUNK_TILES;
+	int tilesWide = SDL_min(CHUNK_TILES, _columns - firstColumn);
+	int tilesHigh = SDL_min(CHUNK_TILES, _rows - firstRow);
+
+	// Placed by rounding both edges, so scaled chunks meet without gaps
+	int x0 = static_cast<int>(std::round(firstColumn * _tileWidth * scale.x));
+	int y0 = static_cast<int>(std::round(firstRow * _tileHeight * scale.y));
+	int x1 = static_cast<int>(std::round((firstColumn + tilesWide) * _tileWidth * scale.x));
+	int y1 = static_cast<int>(std::round((firstRow + tilesHigh) * _tileHeight * scale.y));
+
+	TexturedQuad quad;
+	quad.texture = chunk.texture;
+	quad.srcRect = { 0, 0, tilesWide * _tileWidth, tilesHigh * _tileHeight };
+	quad.dstRect = { x0, y0, x1 - x0, y1 - y0 };
+	_quads.emplace_back(quad);
+}
+
+void Tilemap::countFilledTiles()
+{
+	for (auto& chunk : _chunks)
+	{
+		chunk.filledTiles = 0;
+	}
+
+	for (int row = 0; row < _rows; row++)
+	{
+		for (int column = 0; column < _columns; column++)
+		{
+			if (_tiles[static_cast<std::size_t>(row) * _columns + column] != EMPTY_TILE)
+			{
+				chunkOf(column, row).filledTiles++;
+			}
+		}
+	}
+}
+
+bool Tilemap::bakeChunk(SDL_Renderer* renderer, int chunkColumn, int chunkRow)
+{
+	Chunk& chunk = _chunks[static_cast<std::size_t>(chunkRow) * _chunkColumns + chunkColumn];
+
+	// The snapshot on the render thread may still draw the old contents, so they are baked into a new texture
+	if (chunk.texture != nullptr && Engine::instance().isRenderThreadEnabled())
+	{
+		Engine::instance().destroyTexture(chunk.texture);
+		chunk.texture = nullptr;
+		_bakedChunks--;
+	}
+
+	if (chunk.texture == nullptr)
+	{
+		chunk.texture = acquireChunkTexture(renderer);
+		if (chunk.texture == nullptr)
+		{
+			return false;
+		}
+		_bakedChunks++;
+	}
+
+	SDL_SetRenderTarget(renderer, chunk.texture);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	// Tiles don't overlap, so copy them as they are. Blending onto the transparent target would darken translucent tiles
+	SDL_BlendMode blendMode;
+	SDL_GetTextureBlendMode(texture, &blendMode);
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+	SDL_SetTextureColorMod(texture, 255, 255, 255);
+	SDL_SetTextureAlphaMod(texture, 255);
+
+	int firstColumn = chunkColumn * CHUNK_TILES;
+	int firstRow = chunkRow * CHUNK_TILES;
+	int lastColumn = SDL_min(firstColumn + CHUNK_TILES, _columns);
+	int lastRow = SDL_min(firstRow + CHUNK_TILES, _rows);
+
+	for (int row = firstRow; row < lastRow; row++)
+	{
+		for (int column = firstColumn; column < lastColumn; column++)
+		{
+			uint16_t tile = _tiles[static_cast<std::size_t>(row) * _columns + column];
+			if (tile == EMPTY_TILE)
+			{
+				continue;
+			}
+
+			SDL_Rect src = { _textureOffset.x + (tile % _tilesetColumns) * _tileWidth, _textureOffset.y + (tile / _tilesetColumns) * _tileHeight, _tileWidth, _tileHeight };
+			SDL_Rect dst = { (column - firstColumn) * _tileWidth, (row - firstRow) * _tileHeight, _tileWidth, _tileHeight };
+			SDL_RenderCopy(renderer, texture, &src, &dst);
+		}
+	}
+
+	SDL_SetTextureBlendMode(texture, blendMode);
+	chunk.dirty = false;
+
+	return true;
+}
+
+SDL_Texture* Tilemap::acquireChunkTexture(SDL_Renderer* renderer)
+{
+	if (_bakedChunks >= _maxBakedChunks)
+	{
+		// Take the texture of the chunk that has been out of view the longest
+		Chunk* oldest = nullptr;
+		for (auto& chunk : _chunks)
+		{
+			if (chunk.texture != nullptr && chunk.lastVisibleFrame != _frame && (oldest == nullptr || chunk.lastVisibleFrame < oldest->lastVisibleFrame))
+			{
+				oldest = &chunk;
+			}
+		}
+
+		// Retired rather than reused, the snapshot on the render thread may still draw it with the old chunk
+		if (oldest != nullptr)
+		{
+			Engine::instance().destroyTexture(oldest->texture);
+			oldest->texture = nullptr;
+			oldest->dirty = true;
+			_bakedChunks--;
+		}
+	}
+
+	SDL_Texture* chunkTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, CHUNK_TILES * _tileWidth, CHUNK_TILES * _tileHeight);
+	if (chunkTexture == nullptr)
+	{
+		std::cerr << "Failed to create tilemap chunk! Error: " << SDL_GetError() << std::endl;
+		return nullptr;
+	}
+
+	SDL_SetTextureBlendMode(chunkTexture, SDL_BLENDMODE_BLEND);
+
+	return chunkTexture;
+}
+
+void Tilemap::addTileQuads(int chunkColumn, int chunkRow, const Vector2& scale)
+{
+	int firstColumn = chunkColumn * CHUNK_TILES;
+	int firstRow = chunkRow * CHUNK_TILES;
+	int lastColumn = SDL_min(firstColumn + CHUNK_TILES, _columns);
+	int lastRow = SDL_min(firstRow + CHUNK_TILES, _rows);
+
+	for (int row = firstRow; row < lastRow; row++)
+	{
+		for (int column = firstColumn; column < lastColumn; column++)
+		{
+			uint16_t tile = _tiles[static_cast<std::size_t>(row) * _columns + column];
+			if (tile == EMPTY_TILE)
+			{
+				continue;
+			}
+
+			int x0 = static_cast<int>(std::round(column * _tileWidth * scale.x));
+			int y0 = static_cast<int>(std::round(row * _tileHeight * scale.y));
+			int x1 = static_cast<int>(std::round((column + 1) * _tileWidth * scale.x));
+			int y1 = static_cast<int>(std::round((row + 1) * _tileHeight * scale.y));
+
+			TexturedQuad quad;
+			quad.texture = texture;
+			quad.srcRect = { _textureOffset.x + (tile % _tilesetColumns) * _tileWidth, _textureOffset.y + (tile / _tilesetColumns) * _tileHeight, _tileWidth, _tileHeight };
+			quad.dstRect = { x0, y0, x1 - x0, y1 - y0 };
+			_quads.emplace_back(quad);
+		}
+	}
+}
+
+void Tilemap::releaseChunkTextures()
+{
+	for (auto& chunk : _chunks)
+	{
+		if (chunk.texture != nullptr)
+		{
+			Engine::instance().destroyTexture(chunk.texture);
+			chunk.texture = nullptr;
+		}
+	}
+	_bakedChunks = 0;
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Renderable.h"
+#include "../../RenderLayer.h"
+
+/// <summary>
+/// A grid of tiles drawn from a tileset texture, as a single component instead of an entity per tile.
+/// The map is split into chunks that are baked into render target textures when they come into view,
+/// so only the few chunks intersecting the camera are drawn each frame.
+/// </summary>
+class Tilemap : public Renderable
+{
+public:
+	// Width and height of a chunk, in tiles
+	static constexpr int CHUNK_TILES = 32;
+
+	static constexpr uint16_t EMPTY_TILE = 0xFFFF;
+
+	/// <summary>
+	/// Creates an empty tilemap.
+	/// </summary>
+	/// <param name="renderLayer">The render layer</param>
+	/// <param name="depth">The depth inside the layer</param>
+	/// <param name="tilesetID">The ID of the tileset texture, with the tiles laid out left to right, top to bottom. It may be packed into an atlas</param>
+	/// <param name="tileWidth">The width of a tile</param>
+	/// <param name="tileHeight">The height of a tile</param>
+	/// <param name="columns">The number of tile columns of the map</param>
+	/// <param name="rows">The number of tile rows of the map</param>
+	Tilemap(RenderLayer renderLayer, int depth, const std::string& tilesetID, int tileWidth, int tileHeight, int columns, int rows, float relativePosX = 0.f, float relativePosY = 0.f);
+
+	~Tilemap();
+
+	Tilemap(const Tilemap&) = delete;
+	Tilemap& operator=(const Tilemap&) = delete;
+
+	void init() override;
+
+	/// <summary>
+	/// Tilemaps are drawn as chunk quads, so they have no source rectangle.
+	/// </summary>
+	/// <returns>nullptr</returns>
+	virtual SDL_Rect* srcRect() override { return nullptr; }
+
+	/// <summary>
+	/// Returns the dstRect, covering the whole map.
+	/// </summary>
+	/// <returns>The dstRect</returns>
+	virtual SDL_Rect* dstRect() override { return &_dstRect; }
+
+	/// <summary>
+	/// Returns a quad for every chunk in view of any camera, as of the last updateChunks call.
+	/// </summary>
+	/// <returns>The chunk quads</returns>
+	virtual const std::vector<TexturedQuad>* quads() const override { return &_quads; }
+
+	/// <summary>
+	/// Sets a tile.
+	/// </summary>
+	/// <param name="column">The column of the tile</param>
+	/// <param name="row">The row of the tile</param>
+	/// <param name="tile">The index of the tile in the tileset, or EMPTY_TILE</param>
+	void setTile(int column, int row, uint16_t tile);
+
+	/// <summary>
+	/// Returns a tile.
+	/// </summary>
+	/// <param name="column">The column of the tile</param>
+	/// <param name="row">The row of the tile</param>
+	/// <returns>The index of the tile in the tileset, or EMPTY_TILE if it is empty or outside the map</returns>
+	uint16_t getTile(int column, int row) const;
+
+	/// <summary>
+	/// Replaces every tile of the map.
+	/// </summary>
+	/// <param name="tiles">The tile indices row by row, columns * rows of them</param>
+	void setTiles(const std::vector<uint16_t>& tiles);
+
+	/// <summary>
+	/// Sets every tile of the map to the same tile.
+	/// </summary>
+	/// <param name="tile">The index of the tile in the tileset, or EMPTY_TILE</param>
+	void fill(uint16_t tile);
+
+	/// <summary>
+	/// Sets the tileset texture. Every chunk is baked again.
+	/// </summary>
+	/// <param name="tilesetID">The ID of the tileset texture</param>
+	void setTileset(const std::string& tilesetID);
+
+	/// <summary>
+	/// Returns the ID of the tileset texture.
+	/// </summary>
+	/// <returns>The tileset ID</returns>
+	inline const std::string& getTilesetID() const { return _tilesetID; }
+
+	/// <summary>
+	/// Returns the number of tile columns of the map.
+	/// </summary>
+	/// <returns>The number of columns</returns>
+	inline int getColumns() const { return _columns; }
+
+	/// <summary>
+	/// Returns the number of tile rows of the map.
+	/// </summary>
+	/// <returns>The number of rows</returns>
+	inline int getRows() const { return _rows; }
+
+	/// <summary>
+	/// Returns the width of a tile.
+	/// </summary>
+	/// <returns>The tile width</returns>
+	inline int getTileWidth() const { return _tileWidth; }
+
+	/// <summary>
+	/// Returns the height of a tile.
+	/// </summary>
+	/// <returns>The tile height</returns>
+	inline int getTileHeight() const { return _tileHeight; }
+
+	/// <summary>
+	/// Sets the visible state of this Tilemap.
+	/// </summary>
+	/// <param name="visible">The visible state</param>
+	inline void setVisible(bool visible) { this->visible = visible; }
+
+	/// <summary>
+	/// Sets how many chunk textures are kept at most. Chunks that were out of view the longest give up their texture first.
+	/// </summary>
+	/// <param name="maxBakedChunks">The maximum number of chunk textures</param>
+	inline void setMaxBakedChunks(int maxBakedChunks) { _maxBakedChunks = SDL_max(maxBakedChunks, 1); }
+
+	/// <summary>
+	/// Returns the number of chunks that currently have a baked texture.
+	/// </summary>
+	/// <returns>The number of baked chunks</returns>
+	inline int getBakedChunks() const { return _bakedChunks; }
+
+	/// <summary>
+	/// Marks every chunk to be baked again, e.g. after the render targets were lost.
+	/// </summary>
+	void invalidateChunks();
+
+	/// <summary>
+	/// Bakes the chunks in view of any camera that changed or have no texture yet, and rebuilds the chunk quads.
+	/// The render target is restored afterwards.
+	/// </summary>
+	/// <param name="renderer">The SDL Renderer</param>
+	/// <param name="views">The areas to draw, in world coordinates</param>
+	/// <param name="viewCount">The number of views</param>
+	/// <param name="scale">The scale of the Transform</param>
+	void updateChunks(SDL_Renderer* renderer, const SDL_Rect* views, std::size_t viewCount, const Vector2& scale);
+
+private:
+	struct Chunk
+	{
+		SDL_Texture* texture = nullptr;
+		uint32_t lastVisibleFrame = 0u;
+		int filledTiles = 0;
+		bool dirty = true;
+	};
+
+	std::string _tilesetID;
+	int _tilesetColumns = 0;
+
+	int _tileWidth = 0;
+	int _tileHeight = 0;
+	int _columns = 0;
+	int _rows = 0;
+	std::vector<uint16_t> _tiles;
+
+	int _chunkColumns = 0;
+	int _chunkRows = 0;
+	std::vector<Chunk> _chunks;
+	int _bakedChunks = 0;
+	int _maxBakedChunks = 64;
+	uint32_t _frame = 0u;
+
+	std::vector<TexturedQuad> _quads;
+
+	inline Chunk& chunkOf(int column, int row) { return _chunks[(row / CHUNK_TILES) * _chunkColumns + column / CHUNK_TILES]; }
+
+	void countFilledTiles();
+
+	/// <summary>
+	/// Finds the chunks overlapping a view.
+	/// </summary>
+	/// <returns>False if no chunk overlaps it</returns>
+	bool chunkRange(const SDL_Rect& view, const Vector2& scale, int& minColumn, int& minRow, int& maxColumn, int& maxRow) const;
+
+	void addChunkQuad(const Chunk& chunk, int chunkColumn, int chunkRow, const Vector2& scale);
+
+	/// <summary>
+	/// Draws the tiles of a chunk into its texture.
+	/// </summary>
+	/// <returns>True if the chunk has an up to date texture, false if it couldn't be baked</returns>
+	bool bakeChunk(SDL_Renderer* renderer, int chunkColumn, int chunkRow);
+
+	/// <summary>
+	/// Creates a chunk texture, first retiring the one of the chunk out of view the longest when there are too many.
+	/// Must be called holding the renderer lock.
+	/// </summary>
+	SDL_Texture* acquireChunkTexture(SDL_Renderer* renderer);
+
+	/// <summary>
+	/// Adds a quad for every tile in a chunk, used when the renderer can't bake chunks into render targets.
+	/// </summary>
+	void addTileQuads(int chunkColumn, int chunkRow, const Vector2& scale);
+
+	void releaseChunkTextures();
+};
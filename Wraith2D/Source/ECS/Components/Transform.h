@@ -33,6 +33,54 @@ public:
 
 	}
 
+	/// <summary>
+	/// Stores the current state as the state of the previous simulation step.
+	/// Called by the Engine at the start of every fixed step.
+	/// </summary>
+	inline void storePreviousState()
+	{
+		_previousPosition = position;
+		_previousScale = scale;
+		_previousRotation = rotation;
+		_hasPreviousState = true;
+	}
+
+	/// <summary>
+	/// Discards the previous simulation state so the next rendered frame doesn't interpolate.
+	/// Use it after teleporting an entity.
+	/// </summary>
+	inline void resetInterpolation() { storePreviousState(); }
+
+	/// <summary>
+	/// Returns the position interpolated between the previous and current simulation steps.
+	/// </summary>
+	/// <param name="alpha">The interpolation ratio</param>
+	/// <returns>The interpolated position</returns>
+	inline Vector2 interpolatedPosition(float alpha) const
+	{
+		return _hasPreviousState ? Vector2::lerp(_previousPosition, position, alpha) : position;
+	}
+
+	/// <summary>
+	/// Returns the scale interpolated between the previous and current simulation steps.
+	/// </summary>
+	/// <param name="alpha">The interpolation ratio</param>
+	/// <returns>The interpolated scale</returns>
+	inline Vector2 interpolatedScale(float alpha) const
+	{
+		return _hasPreviousState ? Vector2::lerp(_previousScale, scale, alpha) : scale;
+	}
+
+	/// <summary>
+	/// Returns the rotation interpolated between the previous and current simulation steps.
+	/// </summary>
+	/// <param name="alpha">The interpolation ratio</param>
+	/// <returns>The interpolated rotation</returns>
+	inline float interpolatedRotation(float alpha) const
+	{
+		return _hasPreviousState ? _previousRotation + (rotation - _previousRotation) * alpha : rotation;
+	}
+
 	/// <summary>
 	/// The position in world coordinates
 	/// </summary>
@@ -47,4 +95,10 @@ public:
 	/// The rotation
 	/// </summary>
 	float rotation = 0.f;
+
+private:
+	Vector2 _previousPosition;
+	Vector2 _previousScale = { 1, 1 };
+	float _previousRotation = 0.f;
+	bool _hasPreviousState = false;
 };
\ No newline at end of file
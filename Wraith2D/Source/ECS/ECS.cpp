@@ -1,6 +1,8 @@
 #include "ECS.h"
 
 #include <SDL.h>
+#include "../Profiling/Profiler.h"
+#include "../Profiling/AllocationTracker.h"
 
 /**
 * /////////////////////////////////////////////////////////////////
@@ -56,6 +58,9 @@ EntityManager::EntityManager()
 
 void EntityManager::refresh()
 {
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("EntityManager::refresh");
+
 	for (auto& arch : _entityArchetypes)
 	{	
 		for (auto it = arch->entities.begin(); it != arch->entities.end();)
@@ -90,6 +95,29 @@ void EntityManager::refresh()
 
 }
 
+bool EntityManager::archetypeMatches(const Archetype& archetype, QueryType type, const ComponentID* components, std::size_t componentCount)
+{
+	std::size_t found = 0;
+	for (std::size_t i = 0; i < componentCount; i++)
+	{
+		found += archetype.components.count(components[i]);
+	}
+
+	switch (type)
+	{
+	case QueryType::All:
+		return found == componentCount;
+	case QueryType::Any:
+		return found > 0;
+	case QueryType::None:
+		return found == 0;
+	case QueryType::Exact:
+		return found == componentCount && archetype.components.size() == componentCount;
+	default:
+		return false;
+	}
+}
+
 Entity& EntityManager::createEntity()
 {
 	//Entity* newEntity = new Entity(_entityArchetypes[0]->id, this);
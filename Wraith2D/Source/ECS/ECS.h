@@ -8,6 +8,8 @@
 #include <iterator>
 #include <iostream>
 
+#include "../Memory/FrameArena.h"
+
 class Entity;
 class EntityManager;
 
@@ -49,6 +51,12 @@ public:
 	/// </summary>
 	virtual void update() = 0;
 
+	/// <summary>
+	/// Called once per fixed simulation step, before entities are refreshed.
+	/// Gameplay logic that moves Transforms should live here so rendering can interpolate it.
+	/// </summary>
+	virtual void fixedUpdate() {}
+
 protected:
 	EntityManager* _entityManager;
 };
@@ -212,6 +220,18 @@ public:
 	template<typename... Ts>
 	std::vector<Entity*> getEntitiesWithComponentAll(bool includeInactive = false, bool includeDisabled = false);
 
+	/// <summary>
+	/// Returns all entities that contain all of the supplied components, in a vector allocated from a frame arena.
+	/// Use it for per-frame queries to avoid heap allocations.
+	/// </summary>
+	/// <typeparam name="...Ts">Component type</typeparam>
+	/// <param name="arena">The frame arena the result is allocated from</param>
+	/// <param name="includeInactive">If true, this query will include entities marked for removal.</param>
+	/// <param name="includeDisabled">If true, this query will include disabled entities.</param>
+	/// <returns>Vector with all entities with all of the supplied components</returns>
+	template<typename... Ts>
+	FrameVector<Entity*> getEntitiesWithComponentAll(FrameArena& arena, bool includeInactive = false, bool includeDisabled = false);
+
 	/// <summary>
 	/// Returns all entities that contain any of the supplied components.
 	/// </summary>
@@ -222,6 +242,18 @@ public:
 	template<typename... Ts>
 	std::vector<Entity*> getEntitiesWithComponentAny(bool includeInactive = false, bool includeDisabled = false);
 
+	/// <summary>
+	/// Returns all entities that contain any of the supplied components, in a vector allocated from a frame arena.
+	/// Use it for per-frame queries to avoid heap allocations.
+	/// </summary>
+	/// <typeparam name="...Ts">Component type</typeparam>
+	/// <param name="arena">The frame arena the result is allocated from</param>
+	/// <param name="includeInactive">If true, this query will include entities marked for removal.</param>
+	/// <param name="includeDisabled">If true, this query will include disabled entities.</param>
+	/// <returns>Vector with all entities with any of the supplied components</returns>
+	template<typename... Ts>
+	FrameVector<Entity*> getEntitiesWithComponentAny(FrameArena& arena, bool includeInactive = false, bool includeDisabled = false);
+
 	/// <summary>
 	/// Returns all entities that contain none of the supplied components.
 	/// </summary>
@@ -232,6 +264,18 @@ public:
 	template<typename... Ts>
 	std::vector<Entity*> getEntitiesWithComponentNone(bool includeInactive = false, bool includeDisabled = false);
 
+	/// <summary>
+	/// Returns all entities that contain none of the supplied components, in a vector allocated from a frame arena.
+	/// Use it for per-frame queries to avoid heap allocations.
+	/// </summary>
+	/// <typeparam name="...Ts">Component type</typeparam>
+	/// <param name="arena">The frame arena the result is allocated from</param>
+	/// <param name="includeInactive">If true, this query will include entities marked for removal.</param>
+	/// <param name="includeDisabled">If true, this query will include disabled entities.</param>
+	/// <returns>Vector with all entities with none of the supplied components</returns>
+	template<typename... Ts>
+	FrameVector<Entity*> getEntitiesWithComponentNone(FrameArena& arena, bool includeInactive = false, bool includeDisabled = false);
+
 	/// <summary>
 	/// Returns all entities that contain exactly all of the supplied components.
 	/// </summary>
@@ -242,6 +286,18 @@ public:
 	template<typename... Ts>
 	std::vector<Entity*> getEntitiesWithComponentExact(bool includeInactive = false, bool includeDisabled = false);
 
+	/// <summary>
+	/// Returns all entities that contain exactly all of the supplied components, in a vector allocated from a frame arena.
+	/// Use it for per-frame queries to avoid heap allocations.
+	/// </summary>
+	/// <typeparam name="...Ts">Component type</typeparam>
+	/// <param name="arena">The frame arena the result is allocated from</param>
+	/// <param name="includeInactive">If true, this query will include entities marked for removal.</param>
+	/// <param name="includeDisabled">If true, this query will include disabled entities.</param>
+	/// <returns>Vector with all entities with exactly all of the supplied components</returns>
+	template<typename... Ts>
+	FrameVector<Entity*> getEntitiesWithComponentExact(FrameArena& arena, bool includeInactive = false, bool includeDisabled = false);
+
 private:
 	friend class Entity;
 	std::vector<std::unique_ptr<Archetype>> _entityArchetypes;
@@ -249,6 +305,31 @@ private:
 	unsigned int _lastCleanupTime = 0;
 	const unsigned int CLEANUP_INTERVAL = 60000;
 
+	enum class QueryType
+	{
+		All,
+		Any,
+		None,
+		Exact
+	};
+
+	/// <summary>
+	/// Checks whether an archetype matches a query.
+	/// </summary>
+	/// <param name="archetype">The archetype</param>
+	/// <param name="type">The query type</param>
+	/// <param name="components">The queried components</param>
+	/// <param name="componentCount">The number of queried components</param>
+	/// <returns>True if it matches, false if not</returns>
+	static bool archetypeMatches(const Archetype& archetype, QueryType type, const ComponentID* components, std::size_t componentCount);
+
+	/// <summary>
+	/// Appends every entity of the archetypes matching a query to a container.
+	/// </summary>
+	/// <typeparam name="TContainer">A vector-like container of Entity pointers</typeparam>
+	template<typename TContainer>
+	void collectEntities(TContainer& entities, QueryType type, const ComponentID* components, std::size_t componentCount, bool includeInactive, bool includeDisabled);
+
 	/// <summary>
 	/// Updates the archetypes with the new component(s) of the supplied Entity.
 	/// </summary>
@@ -339,25 +420,27 @@ void EntityManager::updateArchetypes(Entity* entity)
 	_entityArchetypes.emplace_back(std::move(archetypeUPtr));
 }
 
-template<typename... Ts>
-std::vector<Entity*> EntityManager::getEntitiesWithComponentAll(bool includeInactive, bool includeDisabled)
+template<typename TContainer>
+void EntityManager::collectEntities(TContainer& entities, QueryType type, const ComponentID* components, std::size_t componentCount, bool includeInactive, bool includeDisabled)
 {
-	std::vector<ComponentID> components;
-	components.insert(components.end(), { Archetype::getComponentID<Ts>()... });
-
-	std::vector<Entity*> entities;
-
+	// Size the result up front, arena-backed vectors can't give memory back when they grow
+	std::size_t total = 0;
 	for (auto& archetype : _entityArchetypes)
 	{
-		bool containsAll = true;
-
-		// Check if this archetype has ALL of the supplied components
-		for (auto& component : components)
+		if (archetypeMatches(*archetype, type, components, componentCount))
 		{
-			containsAll = containsAll && archetype->components.count(component);
+			total += archetype->entities.size();
+
+			// There's only one archetype with an exact set of components
+			if (type == QueryType::Exact) break;
 		}
+	}
 
-		if (containsAll)
+	entities.reserve(entities.size() + total);
+
+	for (auto& archetype : _entityArchetypes)
+	{
+		if (archetypeMatches(*archetype, type, components, componentCount))
 		{
 			for (auto& entity : archetype->entities)
 			{
@@ -365,8 +448,30 @@ std::vector<Entity*> EntityManager::getEntitiesWithComponentAll(bool includeInac
 
 				entities.emplace_back(entity.second.get());
 			}
+
+			if (type == QueryType::Exact) break;
 		}
 	}
+}
+
+template<typename... Ts>
+std::vector<Entity*> EntityManager::getEntitiesWithComponentAll(bool includeInactive, bool includeDisabled)
+{
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
+
+	std::vector<Entity*> entities;
+	collectEntities(entities, QueryType::All, components, sizeof...(Ts), includeInactive, includeDisabled);
+
+	return entities;
+}
+
+template<typename... Ts>
+FrameVector<Entity*> EntityManager::getEntitiesWithComponentAll(FrameArena& arena, bool includeInactive, bool includeDisabled)
+{
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
+
+	FrameVector<Entity*> entities(arena);
+	collectEntities(entities, QueryType::All, components, sizeof...(Ts), includeInactive, includeDisabled);
 
 	return entities;
 }
@@ -374,31 +479,21 @@ std::vector<Entity*> EntityManager::getEntitiesWithComponentAll(bool includeInac
 template<typename... Ts>
 std::vector<Entity*> EntityManager::getEntitiesWithComponentAny(bool includeInactive, bool includeDisabled)
 {
-	std::vector<ComponentID> components;
-	components.insert(components.end(), { Archetype::getComponentID<Ts>()... });
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
 
 	std::vector<Entity*> entities;
+	collectEntities(entities, QueryType::Any, components, sizeof...(Ts), includeInactive, includeDisabled);
 
-	for (auto& archetype : _entityArchetypes)
-	{
-		bool containsAny = false;
-
-		// Check if this archetype has ANY of the supplied components
-		for (auto& component : components)
-		{
-			containsAny = containsAny || archetype->components.count(component);
-		}
+	return entities;
+}
 
-		if (containsAny)
-		{
-			for (auto& entity : archetype->entities)
-			{
-				if (!entity.second->isActive() && !includeInactive || !entity.second->isEnabled() && !includeDisabled) continue;
+template<typename... Ts>
+FrameVector<Entity*> EntityManager::getEntitiesWithComponentAny(FrameArena& arena, bool includeInactive, bool includeDisabled)
+{
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
 
-				entities.emplace_back(entity.second.get());
-			}
-		}
-	}
+	FrameVector<Entity*> entities(arena);
+	collectEntities(entities, QueryType::Any, components, sizeof...(Ts), includeInactive, includeDisabled);
 
 	return entities;
 }
@@ -406,31 +501,21 @@ std::vector<Entity*> EntityManager::getEntitiesWithComponentAny(bool includeInac
 template<typename... Ts>
 std::vector<Entity*> EntityManager::getEntitiesWithComponentNone(bool includeInactive, bool includeDisabled)
 {
-	std::vector<ComponentID> components;
-	components.insert(components.end(), { Archetype::getComponentID<Ts>()... });
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
 
 	std::vector<Entity*> entities;
+	collectEntities(entities, QueryType::None, components, sizeof...(Ts), includeInactive, includeDisabled);
 
-	for (auto& archetype : _entityArchetypes)
-	{
-		bool containsNone = true;
-
-		// Check if this archetype has ANY of the supplied components
-		for (auto& component : components)
-		{
-			containsNone = containsNone && !archetype->components.count(component);
-		}
+	return entities;
+}
 
-		if (containsNone)
-		{
-			for (auto& entity : archetype->entities)
-			{
-				if (!entity.second->isActive() && !includeInactive || !entity.second->isEnabled() && !includeDisabled) continue;
+template<typename... Ts>
+FrameVector<Entity*> EntityManager::getEntitiesWithComponentNone(FrameArena& arena, bool includeInactive, bool includeDisabled)
+{
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
 
-				entities.emplace_back(entity.second.get());
-			}
-		}
-	}
+	FrameVector<Entity*> entities(arena);
+	collectEntities(entities, QueryType::None, components, sizeof...(Ts), includeInactive, includeDisabled);
 
 	return entities;
 }
@@ -438,34 +523,21 @@ std::vector<Entity*> EntityManager::getEntitiesWithComponentNone(bool includeIna
 template<typename... Ts>
 std::vector<Entity*> EntityManager::getEntitiesWithComponentExact(bool includeInactive, bool includeDisabled)
 {
-	std::vector<ComponentID> components;
-	components.insert(components.end(), { Archetype::getComponentID<Ts>()... });
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
 
 	std::vector<Entity*> entities;
+	collectEntities(entities, QueryType::Exact, components, sizeof...(Ts), includeInactive, includeDisabled);
 
-	for (auto& archetype : _entityArchetypes)
-	{
-		bool containsAll = true;
-
-		// First check if this archetype contains all of the supplied components
-		for (auto& component : components)
-		{
-			containsAll = containsAll && archetype->components.count(component);
-		}
-
-		// Now check if it also contains the EXACT number of components
-		if (containsAll && archetype->components.size() == components.size())
-		{
-			for (auto& entity : archetype->entities)
-			{
-				if (!entity.second->isActive() && !includeInactive || !entity.second->isEnabled() && !includeDisabled) continue;
+	return entities;
+}
 
-				entities.emplace_back(entity.second.get());
-			}
+template<typename... Ts>
+FrameVector<Entity*> EntityManager::getEntitiesWithComponentExact(FrameArena& arena, bool includeInactive, bool includeDisabled)
+{
+	const ComponentID components[] = { Archetype::getComponentID<Ts>()... };
 
-			return entities;
-		}
-	}
+	FrameVector<Entity*> entities(arena);
+	collectEntities(entities, QueryType::Exact, components, sizeof...(Ts), includeInactive, includeDisabled);
 
 	return entities;
 }
\ No newline at end of file
@@ -1,17 +1,26 @@
 #include "AnimationSystem.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
 
 #include "../Components/Animation.h"
+#include "../../Engine.h"
 
 void AnimationSystem::update()
 {
-	for (auto& animEntity : _entityManager->getEntitiesWithComponentAll<Animation>())
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("AnimationSystem");
+
+	// Frames follow the simulation clock, so animations respect time scale and pause
+	Uint64 timeMs = static_cast<Uint64>(Engine::instance().clock().time() * 1000.0);
+
+	for (auto& animEntity : _entityManager->getEntitiesWithComponentAll<Animation>(Engine::instance().frameArena()))
 	{
 		Animation& animation = animEntity->getComponent<Animation>();
-		Animation::AnimationInfo animInfo = animation.getCurrentAnimation();
+		const Animation::AnimationInfo& animInfo = animation.getCurrentAnimation();
 
 		if (!animInfo.loop && (animation.getCurrentFrame() == animInfo.numFrames - 1)) continue;
 
-		int nextFrame = static_cast<int>((SDL_GetTicks() / animInfo.frameDelay) % animInfo.numFrames);
+		int nextFrame = static_cast<int>((timeMs / animInfo.frameDelay) % animInfo.numFrames);
 		animation.getSprite().srcRect()->x = animation.getSprite().srcRect()->w * nextFrame;
 		animation.setCurrentFrame(nextFrame);
 
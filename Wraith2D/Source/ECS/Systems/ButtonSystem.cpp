@@ -1,9 +1,15 @@
 #include "ButtonSystem.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
 #include "../Components/Button.h"
+#include "../../Engine.h"
 
 void ButtonSystem::update()
 {
-	for (auto& buttonEntity : _entityManager->getEntitiesWithComponentAll<Button>(false, true))
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("ButtonSystem");
+
+	for (auto& buttonEntity : _entityManager->getEntitiesWithComponentAll<Button>(Engine::instance().frameArena(), false, true))
 	{
 		Button& button = buttonEntity->getComponent<Button>();
 
@@ -14,17 +20,17 @@ void ButtonSystem::update()
 			continue;
 		}
 
-		if (button.getDefaultTextureID() != "")
+		if (!button.getDefaultTextureID().empty())
 		{
 			button.getSprite().setTexture(button.getDefaultTextureID());
 		}
 
-		if (button.mouseHovering() && button.getHoverTextureID() != "")
+		if (button.mouseHovering() && !button.getHoverTextureID().empty())
 		{
 			button.getSprite().setTexture(button.getHoverTextureID());
 		}
 
-		if (button.buttonDown() && button.getDownTextureID() != "")
+		if (button.buttonDown() && !button.getDownTextureID().empty())
 		{
 			button.getSprite().setTexture(button.getDownTextureID());
 			button.setPressed(true);
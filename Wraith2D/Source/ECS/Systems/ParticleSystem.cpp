@@ -0,0 +1,27 @@
+#include "ParticleSystem.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
+
+#include "../Components/ParticleEmitter.h"
+#include "../../Engine.h"
+
+void ParticleSystem::update()
+{
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("ParticleSystem");
+
+	float alpha = Engine::instance().clock().interpolationAlpha();
+	float deltaTime = Engine::instance().clock().deltaTime();
+
+	for (auto& emitterEntity : _entityManager->getEntitiesWithComponentAll<ParticleEmitter>(Engine::instance().frameArena()))
+	{
+		ParticleEmitter& emitter = emitterEntity->getComponent<ParticleEmitter>();
+		Vector2 position = emitter.getTransform().interpolatedPosition(alpha);
+		Vector2 scale = emitter.getTransform().interpolatedScale(alpha);
+		Vector2 origin(position.x + emitter.getRelativePosition().x * scale.x, position.y + emitter.getRelativePosition().y * scale.y);
+
+		// Particles move every rendered frame, they have no previous state to interpolate from
+		emitter.simulate(deltaTime, origin);
+		emitter.updateSpatialBounds();
+	}
+}
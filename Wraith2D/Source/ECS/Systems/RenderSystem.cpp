@@ -1,21 +1,82 @@
 #include "RenderSystem.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include "../Components/Sprite.h"
 #include "../Components/Text.h"
 
 #include "../../InputManager.h"
+#include "../../Engine.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
 
-
-void RenderSystem::init()
+namespace
 {
-	_sortedRenderables.reserve(RenderLayer::Count);
-	for (std::size_t i = 0; i < RenderLayer::Count; i++)
+	SDL_Color modulate(const SDL_Color& a, const SDL_Color& b)
 	{
-		_sortedRenderables.emplace_back(std::multiset<Renderable*, RenderableComparator>());
+		return SDL_Color{ static_cast<Uint8>(a.r * b.r / 255), static_cast<Uint8>(a.g * b.g / 255), static_cast<Uint8>(a.b * b.b / 255), static_cast<Uint8>(a.a * b.a / 255) };
+	}
+
+	// The bounds of a dst rect rotated around its center like SDL_RenderCopyEx does, rounded outwards
+	SDL_Rect rotatedBounds(const SDL_Rect& dstRect, double angle)
+	{
+		if (angle == 0.0)
+		{
+			return dstRect;
+		}
+
+		double radians = angle * M_PI / 180.0;
+		double halfWidth = (std::fabs(dstRect.w * std::cos(radians)) + std::fabs(dstRect.h * std::sin(radians))) * 0.5;
+		double halfHeight = (std::fabs(dstRect.w * std::sin(radians)) + std::fabs(dstRect.h * std::cos(radians))) * 0.5;
+		double centerX = dstRect.x + dstRect.w * 0.5;
+		double centerY = dstRect.y + dstRect.h * 0.5;
+
+		int left = static_cast<int>(std::floor(centerX - halfWidth));
+		int top = static_cast<int>(std::floor(centerY - halfHeight));
+		int right = static_cast<int>(std::ceil(centerX + halfWidth));
+		int bottom = static_cast<int>(std::ceil(centerY + halfHeight));
+		return SDL_Rect{ left, top, right - left, bottom - top };
+	}
+
+	// Scales an opaque rect in image pixels onto the dst rect, rounding inwards so it never covers a transparent pixel
+	SDL_Rect opaqueWorldRect(const SDL_Rect& opaqueRect, const SDL_Rect& dstRect, const SDL_Rect* srcRect, SDL_RendererFlip flip)
+	{
+		float scaleX = srcRect != nullptr && srcRect->w > 0 ? static_cast<float>(dstRect.w) / srcRect->w : 1.f;
+		float scaleY = srcRect != nullptr && srcRect->h > 0 ? static_cast<float>(dstRect.h) / srcRect->h : 1.f;
+
+		float left = opaqueRect.x * scaleX;
+		float right = (opaqueRect.x + opaqueRect.w) * scaleX;
+		float top = opaqueRect.y * scaleY;
+		float bottom = (opaqueRect.y + opaqueRect.h) * scaleY;
+
+		if (flip & SDL_FLIP_HORIZONTAL)
+		{
+			float flippedLeft = dstRect.w - right;
+			right = dstRect.w - left;
+			left = flippedLeft;
+		}
+
+		if (flip & SDL_FLIP_VERTICAL)
+		{
+			float flippedTop = dstRect.h - bottom;
+			bottom = dstRect.h - top;
+			top = flippedTop;
+		}
+
+		int x0 = dstRect.x + static_cast<int>(std::ceil(left));
+		int y0 = dstRect.y + static_cast<int>(std::ceil(top));
+		int x1 = dstRect.x + static_cast<int>(std::floor(right));
+		int y1 = dstRect.y + static_cast<int>(std::floor(bottom));
+
+		return SDL_Rect{ x0, y0, SDL_max(x1 - x0, 0), SDL_max(y1 - y0, 0) };
 	}
 }
 
+void RenderSystem::init()
+{
+}
+
 void RenderSystem::init(SDL_Window* window, int flags)
 {
 	_renderer = SDL_CreateRenderer(window, -1, flags);
@@ -25,55 +86,858 @@ void RenderSystem::init(SDL_Window* window, int flags)
 		std::cerr << SDL_GetError() << std::endl;
 	}
 
+	setup();
+}
+
+void RenderSystem::init(SDL_Surface* target)
+{
+	_renderer = SDL_CreateSoftwareRenderer(target);
+
+	if (!_renderer)
+	{
+		std::cerr << SDL_GetError() << std::endl;
+	}
+
+	setup();
+}
+
+void RenderSystem::setup()
+{
+	registerBuiltInLayers();
+
 	AssetManager::instance().loadTexture("Cursor", "Assets/Textures/pointer.png");
 
+	Vector2 worldDimensions = Engine::instance().getWorldDimensions();
+	_spatialGrid.resize(static_cast<int>(worldDimensions.x), static_cast<int>(worldDimensions.y), CULLING_CELL_SIZE);
+
 	SDL_ShowCursor(0);
-	_cursorTexture = AssetManager::instance().getTexture("Cursor");
+	SDL_Point cursorOffset = { 0, 0 };
+	_cursorTexture = AssetManager::instance().getTexture("Cursor", cursorOffset);
+	_cursorSrcRect.x = cursorOffset.x;
+	_cursorSrcRect.y = cursorOffset.y;
 }
 
 void RenderSystem::update()
 {
-	auto renderableEntities = _entityManager->getEntitiesWithComponentAny<Sprite, Text>();
-	for (auto& entity : renderableEntities)
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("RenderSystem");
+
+	RenderSnapshot& snapshot = _snapshots[_extractIndex];
+	extract(snapshot);
+
+	if (!isRenderThreadEnabled())
+	{
+		draw(snapshot);
+		_drawStats = snapshot.stats;
+		return;
+	}
+
+	// The other snapshot was handed off last frame, it has to be drawn before this one replaces it
+	waitForRenderThread();
+	_drawStats = _snapshots[_extractIndex ^ 1u].stats;
+	destroyRetiredTextures();
+
+	{
+		std::lock_guard<std::mutex> lock(_handoffMutex);
+		_handedOff = &snapshot;
+	}
+	_handoffCondition.notify_all();
+
+	_extractIndex ^= 1u;
+}
+
+void RenderSystem::setRenderThreadEnabled(bool enabled)
+{
+	if (enabled == isRenderThreadEnabled())
+	{
+		return;
+	}
+
+	if (enabled)
+	{
+		_stopRenderThread = false;
+		_renderThread = std::thread(&RenderSystem::renderThreadLoop, this);
+		return;
+	}
+
+	// The thread draws the snapshot it was handed before it stops
+	{
+		std::lock_guard<std::mutex> lock(_handoffMutex);
+		_stopRenderThread = true;
+	}
+	_handoffCondition.notify_all();
+	_renderThread.join();
+
+	_drawStats = _snapshots[_extractIndex ^ 1u].stats;
+	destroyRetiredTextures();
+}
+
+void RenderSystem::destroyTexture(SDL_Texture* texture)
+{
+	if (texture == nullptr)
+	{
+		return;
+	}
+
+	if (!isRenderThreadEnabled())
+	{
+		SDL_DestroyTexture(texture);
+		return;
+	}
+
+	// The snapshot on the render thread was extracted before the texture was let go, and may still draw it
+	_retiredTextures.emplace_back(texture);
+}
+
+void RenderSystem::waitForRenderThread()
+{
+	std::unique_lock<std::mutex> lock(_handoffMutex);
+	_handoffCondition.wait(lock, [this]() { return _handedOff == nullptr; });
+}
+
+RenderLayer RenderSystem::registerLayer(const std::string& name, int order, LayerSortMode sortMode)
+{
+	RenderLayer existing = findLayer(name);
+	if (existing != RenderLayer::MaxLayers)
+	{
+		return existing;
+	}
+
+	for (int layer = 0; layer < RenderLayer::MaxLayers; layer++)
+	{
+		if (!_layers[layer].registered)
+		{
+			_layers[layer].name = name;
+			_layers[layer].order = order;
+			_layers[layer].sortMode = sortMode;
+			_layers[layer].registered = true;
+			updateDrawOrder();
+
+			return static_cast<RenderLayer>(layer);
+		}
+	}
+
+	std::cerr << "Can't register render layer [" << name << "], all " << RenderLayer::MaxLayers << " layers are in use" << std::endl;
+	return RenderLayer::Background;
+}
+
+RenderLayer RenderSystem::findLayer(const std::string& name) const
+{
+	for (int layer = 0; layer < RenderLayer::MaxLayers; layer++)
+	{
+		if (_layers[layer].registered && _layers[layer].name == name)
+		{
+			return static_cast<RenderLayer>(layer);
+		}
+	}
+
+	return RenderLayer::MaxLayers;
+}
+
+void RenderSystem::setLayerSortMode(RenderLayer layer, LayerSortMode sortMode)
+{
+	if (_layers[layer].sortMode == sortMode)
+	{
+		return;
+	}
+
+	_layers[layer].sortMode = sortMode;
+
+	// Cached tiles were drawn in the old order
+	_layerCaches[layer].invalidateAll();
+}
+
+void RenderSystem::setLayerOrder(RenderLayer layer, int order)
+{
+	_layers[layer].order = order;
+	updateDrawOrder();
+}
+
+void RenderSystem::setLayerStatic(RenderLayer layer, bool isStatic)
+{
+	if (isStatic == _layerCaches[layer].isEnabled())
+	{
+		return;
+	}
+
+	if (!isStatic)
+	{
+		_layerCaches[layer].disable();
+		return;
+	}
+
+	if (!SDL_RenderTargetSupported(_renderer))
+	{
+		std::cerr << "Can't cache static layers, the renderer doesn't support render targets" << std::endl;
+		return;
+	}
+
+	Vector2 worldDimensions = Engine::instance().getWorldDimensions();
+	_layerCaches[layer].enable(static_cast<int>(worldDimensions.x), static_cast<int>(worldDimensions.y));
+}
+
+void RenderSystem::invalidateStaticLayers()
+{
+	for (auto& layerCache : _layerCaches)
+	{
+		layerCache.invalidateAll();
+	}
+}
+
+void RenderSystem::destroy()
+{
+	setRenderThreadEnabled(false);
+
+	for (auto& layerQueue : _layerQueues)
+	{
+		layerQueue.clear();
+	}
+
+	// Cached tiles must go before the renderer that owns them
+	for (auto& layerCache : _layerCaches)
+	{
+		layerCache.disable();
+	}
+
+	if (_scaledTarget != nullptr)
+	{
+		SDL_DestroyTexture(_scaledTarget);
+		_scaledTarget = nullptr;
+	}
+
+	SDL_DestroyRenderer(_renderer);
+}
+
+void RenderSystem::registerBuiltInLayers()
+{
+	registerLayer("Background", 0);
+	registerLayer("Midground", 100);
+	registerLayer("Foreground", 200);
+	registerLayer("UI", 300);
+}
+
+void RenderSystem::updateDrawOrder()
+{
+	_drawOrder.clear();
+	for (int layer = 0; layer < RenderLayer::MaxLayers; layer++)
+	{
+		if (_layers[layer].registered)
+		{
+			_drawOrder.emplace_back(static_cast<RenderLayer>(layer));
+		}
+	}
+
+	std::stable_sort(_drawOrder.begin(), _drawOrder.end(), [this](RenderLayer a, RenderLayer b) { return _layers[a].order < _layers[b].order; });
+}
+
+void RenderSystem::sortByY(FrameVector<YSortEntry>& entries)
+{
+	PROFILE_FUNCTION();
+
+	uint32_t previousPass = _sortPass++;
+
+	// Put the renderables that were sorted in the last pass back in that order, the rest go after them
+	FrameVector<YSortEntry> previousOrder(_lastSortedCount, YSortEntry{ 0, nullptr }, Engine::instance().frameArena());
+	FrameVector<YSortEntry> unranked(Engine::instance().frameArena());
+
+	for (const YSortEntry& entry : entries)
+	{
+		Renderable* renderable = entry.renderable;
+		if (renderable->_sortPass == previousPass && renderable->_sortRank < previousOrder.size())
+		{
+			previousOrder[renderable->_sortRank] = entry;
+		}
+		else
+		{
+			unranked.emplace_back(entry);
+		}
+	}
+
+	std::size_t ranked = entries.size() - unranked.size();
+	std::size_t index = 0u;
+	for (const YSortEntry& entry : previousOrder)
+	{
+		if (entry.renderable != nullptr)
+		{
+			entries[index++] = entry;
+		}
+	}
+
+	std::copy(unranked.begin(), unranked.end(), entries.begin() + index);
+
+	auto lower = [](const YSortEntry& a, const YSortEntry& b) { return a.bottom < b.bottom; };
+
+	if (unranked.size() > ranked / 4u + 16u)
+	{
+		// Too little is left of the last order, e.g. after a camera cut, an insertion sort could go quadratic
+		std::stable_sort(entries.begin(), entries.end(), lower);
+	}
+	else
+	{
+		// Nearly sorted, each renderable only moves past the ones it crossed since the last frame
+		for (std::size_t i = 1u; i < entries.size(); i++)
+		{
+			YSortEntry entry = entries[i];
+			std::size_t j = i;
+			while (j > 0u && lower(entry, entries[j - 1u]))
+			{
+				entries[j] = entries[j - 1u];
+				j--;
+			}
+			entries[j] = entry;
+		}
+	}
+
+	for (std::size_t i = 0u; i < entries.size(); i++)
+	{
+		entries[i].renderable->_sortRank = static_cast<uint32_t>(i);
+		entries[i].renderable->_sortPass = _sortPass;
+	}
+
+	_lastSortedCount = entries.size();
+}
+
+int RenderSystem::sortDepth(Renderable& renderable, LayerSortMode sortMode)
+{
+	switch (sortMode)
+	{
+	case LayerSortMode::Depth:
+		return renderable.getDepth();
+	case LayerSortMode::Y:
+	{
+		SDL_Rect* dstRect = renderable.dstRect();
+		return dstRect->y + dstRect->h;
+	}
+	default:
+		// Everything in one depth range, so the queue only orders by texture
+		return 0;
+	}
+}
+
+void RenderSystem::sortByInsertion(FrameVector<Renderable*>& renderables)
+{
+	std::sort(renderables.begin(), renderables.end(), [](const Renderable* a, const Renderable* b) { return a->_insertionIndex < b->_insertionIndex; });
+}
+
+void RenderSystem::extract(RenderSnapshot& snapshot)
+{
+	PROFILE_FUNCTION();
+
+	Engine& engine = Engine::instance();
+	float alpha = engine.clock().interpolationAlpha();
+
+	snapshot.clear();
+
+	// The frame limiter measured the frame before this one. Its work time includes waiting for vsync in the present,
+	// which would keep the frame time at the target and never let a lowered scale go back up
+	const FrameLimiter::Stats& pacing = engine.frameLimiter().stats();
+	double workTime = SDL_max(pacing.workTime - _presentTime.load(), 0.0);
+	_dynamicResolution.update(workTime, engine.frameLimiter().targetFrameTime());
+	snapshot.resolutionScale = _dynamicResolution.scale();
+
+	FrameVector<Camera*> cameras(engine.frameArena());
+	for (auto& cameraEntity : _entityManager->getEntitiesWithComponentAll<Camera>(engine.frameArena()))
+	{
+		cameras.emplace_back(&cameraEntity->getComponent<Camera>());
+	}
+
+	std::stable_sort(cameras.begin(), cameras.end(), [](const Camera* a, const Camera* b) { return a->getOrder() < b->getOrder(); });
+
+	for (Camera* camera : cameras)
+	{
+		extractCamera(snapshot, *camera, alpha);
+	}
+
+#ifdef WRAITH2D_DEBUG_DRAW_ENABLED
+	snapshot.debugDraw = DebugDraw::list();
+	snapshot.debugDraw.text.sort();
+#endif
+
+	if (_cursorTexture != nullptr)
+	{
+		Vector2 mousePos = InputManager::mousePosition();
+		snapshot.cursorTexture = _cursorTexture;
+		snapshot.cursorSrcRect = _cursorSrcRect;
+		snapshot.cursorDstRect = { mousePos.x, mousePos.y, _cursorSrcRect.w, _cursorSrcRect.h };
+	}
+}
+
+void RenderSystem::extractCamera(RenderSnapshot& snapshot, const Camera& camera, float alpha)
+{
+	SDL_Rect view = camera.worldView(alpha);
+
+	for (RenderLayer layer : _drawOrder)
+	{
+		_layerQueues[layer].clear();
+	}
+
+	_opaqueCommands = 0u;
+
+	// Only what intersects this camera is sorted and drawn
+	FrameVector<Renderable*> visibleRenderables(Engine::instance().frameArena());
+	_spatialGrid.query(view, visibleRenderables);
+
+	// The grid returns them in a different order as handles are reused and things move between cells. The order is the
+	// last tiebreak of the sort key, so without this, overlapping renderables with the same depth and texture would flicker
+	sortByInsertion(visibleRenderables);
+
+	FrameVector<YSortEntry> ySorted(Engine::instance().frameArena());
+	FrameVector<Renderable*> insertionOrdered(Engine::instance().frameArena());
+
+	for (Renderable* renderable : visibleRenderables)
 	{
-		if (entity->hasComponent<Sprite>())
+		RenderLayer layer = renderable->getRenderLayer();
+		if (!renderable->entity->isActive() || !renderable->entity->isEnabled() || !_layers[layer].registered
+			|| !camera.isLayerVisible(layer) || isLayerStatic(layer))
 		{
-			Sprite& sprite = entity->getComponent<Sprite>();
-			_sortedRenderables[sprite.getRenderLayer()].emplace(&sprite);
+			continue;
 		}
-		
-		if (entity->hasComponent<Text>())
+
+		if (_layers[layer].sortMode == LayerSortMode::Y)
+		{
+			ySorted.emplace_back(YSortEntry{ sortDepth(*renderable, LayerSortMode::Y), renderable });
+		}
+		else if (_layers[layer].sortMode == LayerSortMode::None)
 		{
-			Text& text = entity->getComponent<Text>();
-			_sortedRenderables[text.getRenderLayer()].emplace(&text);
+			insertionOrdered.emplace_back(renderable);
 		}
+		else
+		{
+			submit(_layerQueues[layer], *renderable, alpha, view, sortDepth(*renderable, _layers[layer].sortMode));
+		}
+	}
+
+	// Unsorted layers are drawn in creation order, each at a depth of its own
+	if (!insertionOrdered.empty())
+	{
+		for (std::size_t rank = 0; rank < insertionOrdered.size(); rank++)
+		{
+			Renderable& renderable = *insertionOrdered[rank];
+			submit(_layerQueues[renderable.getRenderLayer()], renderable, alpha, view, RenderQueue::depthOfRank(rank));
+		}
+	}
+
+	// Y sorted layers are submitted already in order, so their queues don't need sorting
+	if (!ySorted.empty())
+	{
+		sortByY(ySorted);
+
+		for (const YSortEntry& entry : ySorted)
+		{
+			submit(_layerQueues[entry.renderable->getRenderLayer()], *entry.renderable, alpha, view, entry.bottom);
+		}
+	}
+
+	for (RenderLayer layer : _drawOrder)
+	{
+		// Static layers are drawn from their cached tiles instead
+		if (_layerCaches[layer].isEnabled() && camera.isLayerVisible(layer))
+		{
+			refreshLayerCache(snapshot, layer, view, alpha);
+			_layerCaches[layer].submit(_layerQueues[layer], layer, view);
+		}
+		else if (_layers[layer].sortMode == LayerSortMode::Depth || _layers[layer].sortMode == LayerSortMode::Texture)
+		{
+			_layerQueues[layer].sort();
+		}
+	}
+
+	RenderSnapshot::View& snapshotView = snapshot.addView();
+	snapshotView.viewport = camera.getViewport();
+	snapshotView.origin = SDL_Point{ view.x, view.y };
+	snapshotView.zoom = camera.getZoom();
+
+	if (_opaqueCommands > 0u)
+	{
+		appendUnoccluded(snapshot, snapshotView, view, camera.getZoom());
+		return;
+	}
+
+	for (RenderLayer layer : _drawOrder)
+	{
+		snapshotView.queue.append(_layerQueues[layer]);
+	}
+}
+
+void RenderSystem::appendUnoccluded(RenderSnapshot& snapshot, RenderSnapshot::View& snapshotView, const SDL_Rect& view, float zoom)
+{
+	PROFILE_FUNCTION();
+
+	FrameArena& arena = Engine::instance().frameArena();
+
+	// Where the commands of each layer start in the flags
+	FrameVector<std::size_t> offsets(arena);
+	std::size_t commandCount = 0u;
+	for (RenderLayer layer : _drawOrder)
+	{
+		offsets.emplace_back(commandCount);
+		commandCount += _layerQueues[layer].size();
+	}
+
+	FrameVector<uint8_t> hidden(commandCount, 0u, arena);
+	FrameVector<SDL_Rect> pending(arena);
+	uint64_t pendingRange = 0u;
+
+	_occlusionGrid.reset(view);
+
+	// Walk from the front to the back. Commands with the same layer and depth can be reordered by the batcher,
+	// so their opaque rects only cover what is behind them once the walk leaves their range
+	for (std::size_t drawIndex = _drawOrder.size(); drawIndex-- > 0u;)
+	{
+		const RenderQueue& queue = _layerQueues[_drawOrder[drawIndex]];
+
+		for (std::size_t i = queue.size(); i-- > 0u;)
+		{
+			uint64_t range = RenderQueue::depthRangeOf(queue.keyAt(i));
+			if (range != pendingRange)
+			{
+				for (const SDL_Rect& opaqueRect : pending)
+				{
+					_occlusionGrid.cover(opaqueRect);
+				}
+
+				pending.clear();
+				pendingRange = range;
+			}
+
+			// Rotated commands reach outside their dst rect, so they are only hidden when their rotated bounds are
+			const DrawCommand& command = queue[i];
+			SDL_Rect bounds = rotatedBounds(command.dstRect, command.angle);
+			if (_occlusionGrid.isHidden(bounds))
+			{
+				hidden[offsets[drawIndex] + i] = 1u;
+
+				SDL_Rect visible;
+				SDL_IntersectRect(&bounds, &view, &visible);
+				snapshot.stats.occludedCommands++;
+				snapshot.stats.occludedPixels += static_cast<uint64_t>(visible.w * zoom) * static_cast<uint64_t>(visible.h * zoom);
+				continue;
+			}
+
+			if (command.opaqueRect.w > 0 && command.opaqueRect.h > 0)
+			{
+				pending.emplace_back(command.opaqueRect);
+			}
+		}
+	}
+
+	for (std::size_t drawIndex = 0u; drawIndex < _drawOrder.size(); drawIndex++)
+	{
+		snapshotView.queue.append(_layerQueues[_drawOrder[drawIndex]], hidden.data() + offsets[drawIndex]);
+	}
+}
+
+void RenderSystem::refreshLayerCache(RenderSnapshot& snapshot, RenderLayer layer, const SDL_Rect& view, float alpha)
+{
+	_layerCaches[layer].refresh(_renderer, view, [&](SDL_Texture* target, const SDL_Rect& tileRect)
+		{
+			PROFILE_SCOPE("RenderSystem::refreshLayerCache");
+
+			RenderSnapshot::CacheTile& tile = snapshot.addCacheTile();
+			tile.target = target;
+
+			// The tile texture is the whole target, with the tile's world position at its corner
+			tile.origin = SDL_Point{ tileRect.x, tileRect.y };
+
+			FrameVector<Renderable*> tileRenderables(Engine::instance().frameArena());
+			_spatialGrid.query(tileRect, tileRenderables);
+
+			LayerSortMode sortMode = _layers[layer].sortMode;
+			sortByInsertion(tileRenderables);
+
+			std::size_t rank = 0u;
+			for (Renderable* renderable : tileRenderables)
+			{
+				if (renderable->getRenderLayer() == layer && renderable->entity->isActive() && renderable->entity->isEnabled())
+				{
+					int depth = sortMode == LayerSortMode::None ? RenderQueue::depthOfRank(rank++) : sortDepth(*renderable, sortMode);
+					submit(tile.queue, *renderable, alpha, tileRect, depth);
+				}
+			}
+
+			// Tiles are rarely redrawn, so Y sorted layers are sorted by their bottom edge from scratch here
+			if (sortMode != LayerSortMode::None)
+			{
+				tile.queue.sort();
+			}
+		});
+}
+
+void RenderSystem::draw(RenderSnapshot& snapshot)
+{
+	PROFILE_FUNCTION();
+
+	if (snapshot.cacheTileCount > 0u)
+	{
+		PROFILE_SCOPE("RenderSystem::refreshLayerCache");
+
+		for (std::size_t i = 0; i < snapshot.cacheTileCount; i++)
+		{
+			RenderSnapshot::CacheTile& tile = snapshot.cacheTiles[i];
+
+			SDL_SetRenderTarget(_renderer, tile.target);
+			SDL_SetRenderDrawColor(_renderer, 0, 0, 0, 0);
+			SDL_RenderClear(_renderer);
+
+			_cacheBatcher.draw(_renderer, tile.queue, tile.origin);
+		}
+
+		SDL_SetRenderTarget(_renderer, nullptr);
+	}
+
+	int outputWidth = 0;
+	int outputHeight = 0;
+	SDL_GetRendererOutputSize(_renderer, &outputWidth, &outputHeight);
+
+	// Below or above the output resolution, the views are drawn into a scaled target and stretched to the output afterwards
+	float scale = snapshot.resolutionScale;
+	SDL_Rect scaledRect = { 0, 0, static_cast<int>(std::round(outputWidth * scale)), static_cast<int>(std::round(outputHeight * scale)) };
+	bool scaled = scale != 1.f && prepareScaledTarget(scaledRect.w, scaledRect.h);
+
+	if (scaled)
+	{
+		SDL_SetRenderTarget(_renderer, _scaledTarget);
+	}
+	else
+	{
+		scale = 1.f;
 	}
 
 	SDL_SetRenderDrawColor(_renderer, 0, 0, 0, 0);
 	SDL_RenderClear(_renderer);
 
-	for (auto& layer : _sortedRenderables)
+	for (std::size_t i = 0; i < snapshot.viewCount; i++)
 	{
-		for (auto& renderable : layer)
+		RenderSnapshot::View& view = snapshot.views[i];
+
+		// Both edges are scaled, so neighbouring viewports still meet
+		const SDL_Rect& viewport = view.viewport;
+		int left = static_cast<int>(std::round(viewport.x * scale));
+		int top = static_cast<int>(std::round(viewport.y * scale));
+		SDL_Rect scaledViewport = { left, top,
+			static_cast<int>(std::round((viewport.x + viewport.w) * scale)) - left,
+			static_cast<int>(std::round((viewport.y + viewport.h) * scale)) - top };
+
+		// Set after refreshing the caches, switching the render target resets the viewport
+		SDL_RenderSetViewport(_renderer, &scaledViewport);
+
+		if (view.queue.size() > 0u)
 		{
-			if (renderable->isVisible())
+			_batcher.draw(_renderer, view.queue, view.origin, view.zoom * scale);
+
+			const DrawStats& stats = _batcher.stats();
+			snapshot.stats.commands += stats.commands;
+			snapshot.stats.drawCalls += stats.drawCalls;
+			snapshot.stats.textureSwitches += stats.textureSwitches;
+			snapshot.stats.batches += stats.batches;
+		}
+
+#ifdef WRAITH2D_DEBUG_DRAW_ENABLED
+		if (!snapshot.debugDraw.empty())
+		{
+			PROFILE_SCOPE("RenderSystem::debugDraw");
+
+			DebugDraw::flushShapes(_renderer, snapshot.debugDraw, view.origin, view.zoom * scale);
+
+			if (snapshot.debugDraw.text.size() > 0u)
 			{
-				SDL_RenderCopyEx(_renderer, renderable->getTexture(), renderable->srcRect(), renderable->dstRect(), renderable->getTransform().rotation, nullptr, renderable->getFlip());
+				_batcher.draw(_renderer, snapshot.debugDraw.text, view.origin, view.zoom * scale);
 			}
 		}
+#endif
+	}
 
-		layer.clear();
+	if (scaled)
+	{
+		PROFILE_SCOPE("RenderSystem::upscale");
+
+		SDL_SetRenderTarget(_renderer, nullptr);
+		SDL_RenderSetViewport(_renderer, nullptr);
+		SDL_RenderCopy(_renderer, _scaledTarget, &scaledRect, nullptr);
+	}
+	else
+	{
+		SDL_RenderSetViewport(_renderer, nullptr);
 	}
 
-	Vector2 mousePos = InputManager::mousePosition();
-	SDL_Rect cursorDstRect = { mousePos.x, mousePos.y, _cursorSrcRect.w, _cursorSrcRect.h };
-	SDL_RenderCopy(_renderer, _cursorTexture, &_cursorSrcRect, &cursorDstRect);
+	if (snapshot.cursorTexture != nullptr)
+	{
+		SDL_RenderCopy(_renderer, snapshot.cursorTexture, &snapshot.cursorSrcRect, &snapshot.cursorDstRect);
+	}
 
-	SDL_RenderPresent(_renderer);
+	{
+		PROFILE_SCOPE("RenderSystem::present");
+
+		Uint64 presentStart = SDL_GetPerformanceCounter();
+		SDL_RenderPresent(_renderer);
+		_presentTime.store(static_cast<double>(SDL_GetPerformanceCounter() - presentStart) / SDL_GetPerformanceFrequency());
+	}
 }
 
-void RenderSystem::destroy()
+bool RenderSystem::prepareScaledTarget(int width, int height)
 {
-	_sortedRenderables.clear();
-	SDL_DestroyRenderer(_renderer);
-}
\ No newline at end of file
+	if (width <= 0 || height <= 0)
+	{
+		return false;
+	}
+
+	if (_scaledTarget != nullptr && width <= _scaledTargetWidth && height <= _scaledTargetHeight)
+	{
+		return true;
+	}
+
+	if (!SDL_RenderTargetSupported(_renderer))
+	{
+		return false;
+	}
+
+	if (_scaledTarget != nullptr)
+	{
+		SDL_DestroyTexture(_scaledTarget);
+	}
+
+	// Large enough for every scale up to the output resolution, so lowering the scale never recreates it
+	int outputWidth = 0;
+	int outputHeight = 0;
+	SDL_GetRendererOutputSize(_renderer, &outputWidth, &outputHeight);
+	_scaledTargetWidth = SDL_max(width, outputWidth);
+	_scaledTargetHeight = SDL_max(height, outputHeight);
+
+	_scaledTarget = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, _scaledTargetWidth, _scaledTargetHeight);
+	if (_scaledTarget == nullptr)
+	{
+		std::cerr << "Failed to create the scaled render target! Error: " << SDL_GetError() << std::endl;
+		_scaledTargetWidth = 0;
+		_scaledTargetHeight = 0;
+		return false;
+	}
+
+	// Filtered, so the stretched frame doesn't come out blocky. It replaces the whole output, so nothing is blended
+	SDL_SetTextureScaleMode(_scaledTarget, SDL_ScaleModeLinear);
+	SDL_SetTextureBlendMode(_scaledTarget, SDL_BLENDMODE_NONE);
+
+	return true;
+}
+
+void RenderSystem::renderThreadLoop()
+{
+	PROFILE_THREAD("Render");
+
+	while (true)
+	{
+		RenderSnapshot* snapshot = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock(_handoffMutex);
+			_handoffCondition.wait(lock, [this]() { return _handedOff != nullptr || _stopRenderThread; });
+
+			if (_handedOff == nullptr)
+			{
+				return;
+			}
+
+			snapshot = _handedOff;
+		}
+
+		{
+			auto rendererLock = lockRenderer();
+			draw(*snapshot);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_handoffMutex);
+			_handedOff = nullptr;
+		}
+		_handoffCondition.notify_all();
+	}
+}
+
+void RenderSystem::destroyRetiredTextures()
+{
+	auto rendererLock = lockRenderer();
+
+	for (SDL_Texture* texture : _retiredTextures)
+	{
+		SDL_DestroyTexture(texture);
+	}
+
+	_retiredTextures.clear();
+}
+
+void RenderSystem::submit(RenderQueue& queue, Renderable& renderable, float alpha, const SDL_Rect& view, int depth)
+{
+	if (!renderable.isVisible())
+	{
+		return;
+	}
+
+	const std::vector<TexturedQuad>* quads = renderable.quads();
+	if (quads != nullptr)
+	{
+		SDL_Rect* dstRect = renderable.dstRect();
+
+		for (const TexturedQuad& quad : *quads)
+		{
+			DrawCommand command;
+			command.dstRect = { dstRect->x + quad.dstRect.x, dstRect->y + quad.dstRect.y, quad.dstRect.w, quad.dstRect.h };
+
+			// Large renderables like tilemaps and particle effects are only partly in view
+			if (!SDL_HasIntersection(&command.dstRect, &view))
+			{
+				continue;
+			}
+
+			command.texture = quad.texture;
+			command.srcRect = quad.srcRect;
+			command.hasSrcRect = true;
+			command.color = modulate(quad.color, renderable.getTint());
+
+			// Solid fills of an opaque color cover their whole rect
+			if (command.texture == nullptr && command.color.a == 255)
+			{
+				command.opaqueRect = command.dstRect;
+				_opaqueCommands++;
+			}
+
+			queue.submit(command, renderable.getRenderLayer(), depth);
+		}
+
+		return;
+	}
+
+	if (renderable.getTexture() == nullptr)
+	{
+		return;
+	}
+
+	DrawCommand command;
+	command.texture = renderable.getTexture();
+	command.dstRect = *renderable.dstRect();
+	command.angle = renderable.getTransform().interpolatedRotation(alpha);
+	command.flip = renderable.getFlip();
+	command.color = renderable.getTint();
+
+	SDL_Rect* srcRect = renderable.srcRect();
+	if (srcRect != nullptr)
+	{
+		// Atlas images keep their srcRect relative to the image, so offset it into the atlas page
+		SDL_Point offset = renderable.getTextureOffset();
+		command.srcRect = *srcRect;
+		command.srcRect.x += offset.x;
+		command.srcRect.y += offset.y;
+		command.hasSrcRect = true;
+	}
+
+	// Rotated or translucent draws don't cover a rect of the screen
+	const SDL_Rect& opaqueRect = renderable.getOpaqueRect();
+	if (opaqueRect.w > 0 && opaqueRect.h > 0 && command.angle == 0.0 && command.color.a == 255)
+	{
+		command.opaqueRect = opaqueWorldRect(opaqueRect, command.dstRect, srcRect, command.flip);
+		if (command.opaqueRect.w > 0 && command.opaqueRect.h > 0)
+		{
+			_opaqueCommands++;
+		}
+	}
+
+	queue.submit(command, renderable.getRenderLayer(), depth);
+}
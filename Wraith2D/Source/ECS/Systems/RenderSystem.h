@@ -1,11 +1,23 @@
 #pragma once
 
 #include <SDL.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
-#include <set>
 
 #include "../ECS.h"
 #include "../Components/Renderable.h"
+#include "../Components/Camera.h"
+#include "../../Rendering/RenderQueue.h"
+#include "../../Rendering/SpriteBatcher.h"
+#include "../../Rendering/SpatialGrid.h"
+#include "../../Rendering/LayerCache.h"
+#include "../../Rendering/RenderSnapshot.h"
+#include "../../Rendering/OcclusionGrid.h"
+#include "../../Rendering/DynamicResolution.h"
 
 class RenderSystem : public System
 {
@@ -15,26 +27,303 @@ public:
 	void init() override;
 	void init(SDL_Window* window, int flags);
 
+	/// <summary>
+	/// Initializes the system with SDL's software renderer, drawing into a surface instead of a window.
+	/// </summary>
+	/// <param name="target">The surface to render to</param>
+	void init(SDL_Surface* target);
+
+	/// <summary>
+	/// Extracts the draw data of the frame into a snapshot, then draws it, or hands it to the render thread.
+	/// </summary>
 	virtual void update() override;
 
 	inline SDL_Renderer* SDLRenderer() { return _renderer; }
 
+	/// <summary>
+	/// Draws snapshots on a thread of their own, so the next frame is simulated while the last one is drawn.
+	/// Only for renderers that can be driven from another thread, like Direct3D and the software renderer.
+	/// Everything else that uses the renderer while the thread runs has to hold lockRenderer().
+	/// </summary>
+	/// <param name="enabled">Flag to use the render thread or not</param>
+	void setRenderThreadEnabled(bool enabled);
+
+	/// <summary>
+	/// Checks whether snapshots are drawn on the render thread.
+	/// </summary>
+	/// <returns>True if they are, false if not</returns>
+	inline bool isRenderThreadEnabled() const { return _renderThread.joinable(); }
+
+	/// <summary>
+	/// Locks the renderer against the render thread. Textures must only be created or updated while holding it.
+	/// </summary>
+	/// <returns>The lock, released when it goes out of scope</returns>
+	inline std::unique_lock<std::recursive_mutex> lockRenderer() { return std::unique_lock<std::recursive_mutex>(_rendererMutex); }
+
+	/// <summary>
+	/// Destroys a texture once the snapshot being drawn can't reference it anymore.
+	/// </summary>
+	/// <param name="texture">The texture to destroy</param>
+	void destroyTexture(SDL_Texture* texture);
+
+	/// <summary>
+	/// Blocks until the render thread has drawn the snapshot it was handed.
+	/// </summary>
+	void waitForRenderThread();
+
+	/// <summary>
+	/// Returns the controller of the resolution scale, which renders the world into a smaller target and stretches it
+	/// to the output when frames take too long.
+	/// </summary>
+	/// <returns>A reference to the dynamic resolution controller</returns>
+	inline DynamicResolution& dynamicResolution() { return _dynamicResolution; }
+
+	/// <summary>
+	/// Returns the draw calls, texture switches and batches of the last drawn frame, summed over every camera.
+	/// </summary>
+	/// <returns>The draw statistics</returns>
+	inline const DrawStats& drawStats() const { return _drawStats; }
+
+	/// <summary>
+	/// Returns the spatial grid with the world bounds of every renderable, used to cull everything outside the camera.
+	/// </summary>
+	/// <returns>A reference to the spatial grid</returns>
+	inline SpatialGrid& spatialGrid() { return _spatialGrid; }
+
+	/// <summary>
+	/// Registers a render layer. Layers are drawn from the lowest to the highest order.
+	/// The built-in layers have the orders 0 (Background), 100 (Midground), 200 (Foreground) and 300 (UI).
+	/// </summary>
+	/// <param name="name">The name of the layer</param>
+	/// <param name="order">Where the layer is drawn relative to the others</param>
+	/// <param name="sortMode">How the renderables of the layer are ordered</param>
+	/// <returns>The new layer, the existing one if the name is taken, or Background if every layer ID is used</returns>
+	RenderLayer registerLayer(const std::string& name, int order, LayerSortMode sortMode = LayerSortMode::Depth);
+
+	/// <summary>
+	/// Finds a render layer by name.
+	/// </summary>
+	/// <param name="name">The name of the layer</param>
+	/// <returns>The layer, or RenderLayer::MaxLayers if none has the name</returns>
+	RenderLayer findLayer(const std::string& name) const;
+
+	/// <summary>
+	/// Sets how the renderables of a layer are ordered before drawing.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="sortMode">The sort mode</param>
+	void setLayerSortMode(RenderLayer layer, LayerSortMode sortMode);
+
+	/// <summary>
+	/// Returns how the renderables of a layer are ordered before drawing.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <returns>The sort mode</returns>
+	inline LayerSortMode getLayerSortMode(RenderLayer layer) const { return _layers[layer].sortMode; }
+
+	/// <summary>
+	/// Changes where a layer is drawn relative to the others.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="order">The new order</param>
+	void setLayerOrder(RenderLayer layer, int order);
+
+	/// <summary>
+	/// Flags a render layer as static. Static layers are rendered once into cached tiles, which are drawn
+	/// instead of their renderables and only re-rendered when something in them changes.
+	/// Only the part of the layer inside the game world is cached. Changes to renderables are detected,
+	/// but enabling or disabling their entities isn't, so invalidate the area after doing that.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="isStatic">Flag to cache the layer or not</param>
+	void setLayerStatic(RenderLayer layer, bool isStatic);
+
+	/// <summary>
+	/// Checks whether a render layer is cached as static.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isLayerStatic(RenderLayer layer) const { return _layerCaches[layer].isEnabled(); }
+
+	/// <summary>
+	/// Marks an area of a static layer to be re-rendered.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="area">The area in world coordinates</param>
+	inline void invalidateStaticLayer(RenderLayer layer, const SDL_Rect& area) { _layerCaches[layer].invalidate(area); }
+
+	/// <summary>
+	/// Marks every static layer to be re-rendered, e.g. after the render targets were lost.
+	/// </summary>
+	void invalidateStaticLayers();
+
 	void destroy();
 
 private:
-	struct RenderableComparator
+	static constexpr int CULLING_CELL_SIZE = 256;
+
+	struct LayerSettings
+	{
+		std::string name;
+		int order = 0;
+		LayerSortMode sortMode = LayerSortMode::Depth;
+		bool registered = false;
+	};
+
+	// A renderable of a Y sorted layer and the bottom edge it is sorted by
+	struct YSortEntry
 	{
-		bool operator()(const Renderable* r1, const Renderable* r2) const
-		{
-			return r1->getDepth() < r2->getDepth();
-		}
+		int bottom;
+		Renderable* renderable;
 	};
-	
 
-	std::vector<std::multiset<Renderable*, RenderableComparator>> _sortedRenderables;
+	SpatialGrid _spatialGrid;
+	SpriteBatcher _batcher;
+	DrawStats _drawStats;
+
+	// One snapshot is extracted while the other is drawn
+	RenderSnapshot _snapshots[2];
+	std::size_t _extractIndex = 0u;
+
+	std::thread _renderThread;
+	std::mutex _handoffMutex;
+	std::condition_variable _handoffCondition;
+	RenderSnapshot* _handedOff = nullptr;
+	bool _stopRenderThread = false;
+
+	std::recursive_mutex _rendererMutex;
+	std::vector<SDL_Texture*> _retiredTextures;
+
+	LayerSettings _layers[RenderLayer::MaxLayers];
+	std::vector<RenderLayer> _drawOrder;
+
+	// Each layer is sorted on its own, or not at all
+	RenderQueue _layerQueues[RenderLayer::MaxLayers];
+
+	uint32_t _sortPass = 0u;
+	std::size_t _lastSortedCount = 0u;
+
+	DynamicResolution _dynamicResolution;
+
+	// How long the last present blocked, in seconds. It waits for vsync, so it is left out of the time the scale is picked by.
+	// Written by the thread that draws
+	std::atomic<double> _presentTime{ 0.0 };
+
+	// Reused while the scale stays at or below the size it was created for
+	SDL_Texture* _scaledTarget = nullptr;
+	int _scaledTargetWidth = 0;
+	int _scaledTargetHeight = 0;
+
+	// The occlusion pass only runs for cameras that see an opaque draw
+	OcclusionGrid _occlusionGrid;
+	uint32_t _opaqueCommands = 0u;
+
+	LayerCache _layerCaches[RenderLayer::MaxLayers];
+	SpriteBatcher _cacheBatcher;
 
 	SDL_Texture* _cursorTexture;
 	SDL_Rect _cursorSrcRect = { 0, 0, 21, 20 };
 
 	SDL_Renderer* _renderer;
+
+	/// <summary>
+	/// Loads the cursor and sizes the spatial grid once the renderer exists.
+	/// </summary>
+	void setup();
+
+	/// <summary>
+	/// Registers the built-in layers.
+	/// </summary>
+	void registerBuiltInLayers();
+
+	/// <summary>
+	/// Rebuilds the list of registered layers in draw order.
+	/// </summary>
+	void updateDrawOrder();
+
+	/// <summary>
+	/// Sorts the renderables of Y sorted layers by their bottom edge, starting from the order of the last sort,
+	/// so renderables that didn't move past each other cost a single comparison.
+	/// </summary>
+	/// <param name="entries">The renderables, sorted in place</param>
+	void sortByY(FrameVector<YSortEntry>& entries);
+
+	/// <summary>
+	/// Returns the depth a renderable is submitted with under a sort mode. Layers that aren't sorted use their insertion order instead.
+	/// </summary>
+	static int sortDepth(Renderable& renderable, LayerSortMode sortMode);
+
+	/// <summary>
+	/// Sorts culled renderables by their creation order, so it breaks ties in the sort key the same way every frame.
+	/// Renderables of layers that aren't sorted are then submitted at the depth of their rank, a depth range of their own,
+	/// so neither the queue nor the batcher can move them past another.
+	/// </summary>
+	/// <param name="renderables">The renderables, sorted in place</param>
+	static void sortByInsertion(FrameVector<Renderable*>& renderables);
+
+	/// <summary>
+	/// Culls and sorts the world as seen by every camera into a snapshot.
+	/// </summary>
+	/// <param name="snapshot">The snapshot to fill</param>
+	void extract(RenderSnapshot& snapshot);
+
+	/// <summary>
+	/// Culls and sorts the world as seen by a camera, adding it to the snapshot as a view.
+	/// </summary>
+	/// <param name="snapshot">The snapshot to fill</param>
+	/// <param name="camera">The camera</param>
+	/// <param name="alpha">The interpolation ratio between the last two simulation steps</param>
+	void extractCamera(RenderSnapshot& snapshot, const Camera& camera, float alpha);
+
+	/// <summary>
+	/// Appends the sorted layer queues to a view of the snapshot, leaving out the commands fully hidden behind opaque draws in front.
+	/// </summary>
+	/// <param name="snapshot">The snapshot, whose occlusion statistics are updated</param>
+	/// <param name="snapshotView">The view the commands are appended to</param>
+	/// <param name="view">The view of the camera in world coordinates</param>
+	/// <param name="zoom">The zoom of the camera, to count the screen pixels saved</param>
+	void appendUnoccluded(RenderSnapshot& snapshot, RenderSnapshot::View& snapshotView, const SDL_Rect& view, float zoom);
+
+	/// <summary>
+	/// Records the invalidated tiles of a static layer that are in view, to be re-rendered when the snapshot is drawn.
+	/// </summary>
+	/// <param name="snapshot">The snapshot to fill</param>
+	/// <param name="layer">The render layer</param>
+	/// <param name="view">The view of the camera in world coordinates</param>
+	/// <param name="alpha">The interpolation ratio for the rotation</param>
+	void refreshLayerCache(RenderSnapshot& snapshot, RenderLayer layer, const SDL_Rect& view, float alpha);
+
+	/// <summary>
+	/// Issues the draw calls of a snapshot and presents it. The only part of a frame that calls into the renderer.
+	/// </summary>
+	/// <param name="snapshot">The snapshot to draw</param>
+	void draw(RenderSnapshot& snapshot);
+
+	/// <summary>
+	/// Makes sure the scaled target can hold a frame of the given size, creating it the first time or when it is too small.
+	/// </summary>
+	/// <param name="width">The scaled width</param>
+	/// <param name="height">The scaled height</param>
+	/// <returns>True if the target is ready, false if the renderer can't provide one</returns>
+	bool prepareScaledTarget(int width, int height);
+
+	/// <summary>
+	/// Waits for snapshots and draws them, until told to stop.
+	/// </summary>
+	void renderThreadLoop();
+
+	/// <summary>
+	/// Destroys the textures retired while the last snapshot was drawn.
+	/// </summary>
+	void destroyRetiredTextures();
+
+	/// <summary>
+	/// Adds draw commands in world coordinates for a visible renderable to a render queue.
+	/// </summary>
+	/// <param name="queue">The render queue</param>
+	/// <param name="renderable">The renderable</param>
+	/// <param name="alpha">The interpolation ratio for the rotation</param>
+	/// <param name="view">The area being drawn in world coordinates, quads outside it are skipped</param>
+	/// <param name="depth">The depth it is submitted at, from sortDepth or its insertion rank</param>
+	void submit(RenderQueue& queue, Renderable& renderable, float alpha, const SDL_Rect& view, int depth);
 };
\ No newline at end of file
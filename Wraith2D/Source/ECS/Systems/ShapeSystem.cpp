@@ -0,0 +1,25 @@
+#include "ShapeSystem.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
+
+#include "../Components/Shape.h"
+#include "../../Engine.h"
+
+void ShapeSystem::update()
+{
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("ShapeSystem");
+
+	float alpha = Engine::instance().clock().interpolationAlpha();
+
+	for (auto& shapeEntity : _entityManager->getEntitiesWithComponentAll<Shape>(Engine::instance().frameArena()))
+	{
+		Shape& shape = shapeEntity->getComponent<Shape>();
+		Vector2 position = shape.getTransform().interpolatedPosition(alpha);
+		Vector2 scale = shape.getTransform().interpolatedScale(alpha);
+		Vector2 origin(position.x + shape.getRelativePosition().x * scale.x, position.y + shape.getRelativePosition().y * scale.y);
+
+		shape.place(origin, scale);
+		shape.updateSpatialBounds();
+	}
+}
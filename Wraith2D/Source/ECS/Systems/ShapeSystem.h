@@ -0,0 +1,11 @@
+#pragma once
+
+#include "../ECS.h"
+
+class ShapeSystem : public System
+{
+public:
+	using System::System;
+
+	virtual void update() override;
+};
@@ -1,22 +1,40 @@
 #include "SpriteSystem.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
 #include <stdlib.h>
 
 #include "../Components/Sprite.h"
+#include "../../Engine.h"
 
 void SpriteSystem::update()
 {
-	auto spriteEntities = _entityManager->getEntitiesWithComponentAll<Sprite>();
-	for (auto& spriteEntity : spriteEntities)
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("SpriteSystem");
+
+	float alpha = Engine::instance().clock().interpolationAlpha();
+
+	_kernel.clear();
+	_sprites.clear();
+
+	for (auto& spriteEntity : _entityManager->getEntitiesWithComponentAll<Sprite>(Engine::instance().frameArena()))
 	{
 		Sprite& sprite = spriteEntity->getComponent<Sprite>();
+		const Transform& transform = sprite.getTransform();
 
-		sprite.srcRect()->w = sprite.getSrcWidth();
-		sprite.srcRect()->h = sprite.getSrcHeight();
-		sprite.dstRect()->x = static_cast<int>(std::round(sprite.getTransform().position.x + sprite.getRelativePosition().x * sprite.getTransform().scale.x));
-		sprite.dstRect()->y = static_cast<int>(std::round(sprite.getTransform().position.y + sprite.getRelativePosition().y * sprite.getTransform().scale.y));
-		sprite.dstRect()->w = static_cast<int>(std::round(sprite.getDstWidth() * sprite.getTransform().scale.x));
-		sprite.dstRect()->h = static_cast<int>(std::round(sprite.getDstHeight() * sprite.getTransform().scale.y));
+		_sprites.emplace_back(&sprite);
+		_kernel.add(transform.interpolatedPosition(alpha), transform.interpolatedScale(alpha), sprite.getRelativePosition(),
+			static_cast<float>(sprite.getDstWidth()), static_cast<float>(sprite.getDstHeight()));
+	}
+
+	// The rects of every sprite are computed in one pass over contiguous arrays
+	_rects.resize(_sprites.size());
+	_kernel.run(_rects.data());
 
-		sprite.makeDstRelativeToCamera();
+	for (std::size_t i = 0; i < _sprites.size(); i++)
+	{
+		Sprite& sprite = *_sprites[i];
+		sprite.setSrcDimensions(sprite.getSrcWidth(), sprite.getSrcHeight());
+		sprite.setDstRect(_rects[i]);
+		sprite.updateSpatialBounds();
 	}
-}
\ No newline at end of file
+}
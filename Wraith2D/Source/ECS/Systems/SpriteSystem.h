@@ -1,6 +1,12 @@
 #pragma once
 
+#include <SDL.h>
+#include <vector>
+
 #include "../ECS.h"
+#include "../../Math/TransformKernel.h"
+
+class Sprite;
 
 class SpriteSystem : public System
 {
@@ -8,4 +14,10 @@ public:
 	using System::System;
 
 	virtual void update() override;
-};
\ No newline at end of file
+
+private:
+	// Kept between frames so the arrays are only allocated while the sprite count grows
+	TransformKernel _kernel;
+	std::vector<Sprite*> _sprites;
+	std::vector<SDL_Rect> _rects;
+};
@@ -1,15 +1,25 @@
 #include "TextSystem.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
 #include <stdlib.h>
 
 #include "../Components/Text.h"
 
 void TextSystem::update()
 {
-	for (auto& textEntity : _entityManager->getEntitiesWithComponentAll<Text>())
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("TextSystem");
+
+	float alpha = Engine::instance().clock().interpolationAlpha();
+
+	for (auto& textEntity : _entityManager->getEntitiesWithComponentAll<Text>(Engine::instance().frameArena()))
 	{
 		Text& text = textEntity->getComponent<Text>();
-		text.dstRect()->x = static_cast<int>(std::round(text.getTransform().position.x + text.getRelativePosition().x * text.getTransform().scale.x));
-		text.dstRect()->y = static_cast<int>(std::round(text.getTransform().position.y + text.getRelativePosition().y * text.getTransform().scale.y));
-		text.makeDstRelativeToCamera();
+		Vector2 position = text.getTransform().interpolatedPosition(alpha);
+		Vector2 scale = text.getTransform().interpolatedScale(alpha);
+
+		text.dstRect()->x = static_cast<int>(std::round(position.x + text.getRelativePosition().x * scale.x));
+		text.dstRect()->y = static_cast<int>(std::round(position.y + text.getRelativePosition().y * scale.y));
+		text.updateSpatialBounds();
 	}
 }
\ No newline at end of file
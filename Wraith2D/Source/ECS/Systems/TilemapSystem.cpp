@@ -0,0 +1,58 @@
+#include "TilemapSystem.h"
+#include "../../Profiling/Profiler.h"
+#include "../../Profiling/AllocationTracker.h"
+
+#include "../Components/Tilemap.h"
+#include "../Components/Camera.h"
+#include "../../Engine.h"
+#include "../../Rendering/LayerCache.h"
+
+void TilemapSystem::update()
+{
+	PROFILE_FUNCTION();
+	ALLOCATION_TAG("TilemapSystem");
+
+	Engine& engine = Engine::instance();
+	float alpha = engine.clock().interpolationAlpha();
+
+	FrameVector<SDL_Rect> cameraViews(engine.frameArena());
+	for (auto& cameraEntity : _entityManager->getEntitiesWithComponentAll<Camera>(engine.frameArena()))
+	{
+		cameraViews.emplace_back(cameraEntity->getComponent<Camera>().worldView(alpha));
+	}
+
+	// Cached layer tiles can reach past the camera, so tilemaps on static layers need every chunk under them
+	FrameVector<SDL_Rect> cacheViews(engine.frameArena());
+	for (const SDL_Rect& camera : cameraViews)
+	{
+		int right = (camera.x + camera.w + LayerCache::TILE_SIZE - 1) / LayerCache::TILE_SIZE * LayerCache::TILE_SIZE;
+		int bottom = (camera.y + camera.h + LayerCache::TILE_SIZE - 1) / LayerCache::TILE_SIZE * LayerCache::TILE_SIZE;
+		int left = SDL_max(camera.x, 0) / LayerCache::TILE_SIZE * LayerCache::TILE_SIZE;
+		int top = SDL_max(camera.y, 0) / LayerCache::TILE_SIZE * LayerCache::TILE_SIZE;
+		cacheViews.emplace_back(SDL_Rect{ left, top, right - left, bottom - top });
+	}
+
+	for (auto& tilemapEntity : _entityManager->getEntitiesWithComponentAll<Tilemap>(engine.frameArena()))
+	{
+		Tilemap& tilemap = tilemapEntity->getComponent<Tilemap>();
+		Vector2 position = tilemap.getTransform().interpolatedPosition(alpha);
+		Vector2 scale = tilemap.getTransform().interpolatedScale(alpha);
+
+		tilemap.dstRect()->x = static_cast<int>(std::round(position.x + tilemap.getRelativePosition().x * scale.x));
+		tilemap.dstRect()->y = static_cast<int>(std::round(position.y + tilemap.getRelativePosition().y * scale.y));
+		tilemap.dstRect()->w = static_cast<int>(std::round(tilemap.getColumns() * tilemap.getTileWidth() * scale.x));
+		tilemap.dstRect()->h = static_cast<int>(std::round(tilemap.getRows() * tilemap.getTileHeight() * scale.y));
+
+		const FrameVector<SDL_Rect>& views = engine.isLayerStatic(tilemap.getRenderLayer()) ? cacheViews : cameraViews;
+		tilemap.updateChunks(engine.getRenderer(), views.data(), views.size(), scale);
+		tilemap.updateSpatialBounds();
+	}
+}
+
+void TilemapSystem::invalidateChunks()
+{
+	for (auto& tilemapEntity : _entityManager->getEntitiesWithComponentAll<Tilemap>(Engine::instance().frameArena(), true, true))
+	{
+		tilemapEntity->getComponent<Tilemap>().invalidateChunks();
+	}
+}
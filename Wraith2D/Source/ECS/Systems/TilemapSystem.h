@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../ECS.h"
+
+class TilemapSystem : public System
+{
+public:
+	using System::System;
+
+	virtual void update() override;
+
+	/// <summary>
+	/// Marks every chunk of every tilemap to be baked again, e.g. after the render targets were lost.
+	/// </summary>
+	void invalidateChunks();
+};
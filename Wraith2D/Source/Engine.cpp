@@ -1,11 +1,18 @@
 #include "Engine.h"
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <stdlib.h>
+#include <typeinfo>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
 #include "InputManager.h"
 #include "ECS/Components/Transform.h"
+#include "ECS/Components/Text.h"
 #include "AssetManager.h"
-
-//constexpr unsigned int FPS_COUNT_DELAY = 100u;
+#include "Profiling/Profiler.h"
+#include "Profiling/AllocationTracker.h"
 
 Engine::Engine()
 {
@@ -20,6 +27,9 @@ Engine::~Engine()
 
 void Engine::init(const char* title, int width, int height, bool fullscreen, bool vsync, int worldWidth, int worldHeight)
 {
+	PROFILE_THREAD("Main");
+	PROFILE_FUNCTION();
+
 	if (SDL_Init(SDL_INIT_VIDEO) < 0)
 	{
 		std::cerr << SDL_GetError() << std::endl;
@@ -33,25 +43,54 @@ void Engine::init(const char* title, int width, int height, bool fullscreen, boo
 		std::cerr << SDL_GetError() << std::endl;
 	}
 
-	_entityManager = new EntityManager();
+	initWorld(width, height, worldWidth, worldHeight);
 
-	_camera.x = 0;
-	_camera.y = 0;
-	_camera.w = width;
-	_camera.h = height;
+	_renderSystem = &createSystem<RenderSystem>();
+	auto rendererFlags = vsync ? (SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE) : (SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
+	_renderSystem->init(_window, rendererFlags);
 
-	_worldDimensions.x = static_cast<float>(worldWidth);
-	_worldDimensions.y = static_cast<float>(worldHeight);
+	initSystems();
+
+	// Without vsync the loop would spin as fast as it can, so pace it to the display refresh rate instead
+	SDL_DisplayMode displayMode;
+	if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(_window), &displayMode) == 0 && displayMode.refresh_rate > 0)
+	{
+		_frameLimiter.setTargetFrameRate(displayMode.refresh_rate);
+	}
+	_frameLimiter.setEnabled(!vsync);
+
+	_clock.reset();
+	_isRunning = true;
+}
+
+void Engine::initHeadless(int width, int height, int worldWidth, int worldHeight)
+{
+	PROFILE_THREAD("Main");
+	PROFILE_FUNCTION();
+
+	// No video subsystem, so this runs on machines without a display or GPU
+	if (SDL_Init(SDL_INIT_EVENTS) < 0)
+	{
+		std::cerr << SDL_GetError() << std::endl;
+	}
+
+	_offscreenSurface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_ARGB8888);
+	if (!_offscreenSurface)
+	{
+		std::cerr << SDL_GetError() << std::endl;
+	}
+
+	initWorld(width, height, worldWidth, worldHeight);
 
 	_renderSystem = &createSystem<RenderSystem>();
-	auto rendererFlags = vsync ? (SDL_RENDERER_PRESENTVSYNC | SDL_RENDERER_ACCELERATED) : SDL_RENDERER_ACCELERATED;
-	_renderSystem->init(_window, rendererFlags);
+	_renderSystem->init(_offscreenSurface);
 
-	_spriteSystem = &createSystem<SpriteSystem>();
-	_textSystem = &createSystem<TextSystem>();
-	_animationSystem = &createSystem<AnimationSystem>();
-	_buttonSystem = &createSystem<ButtonSystem>();
+	initSystems();
+
+	// Headless runs are for measuring, never pace them
+	_frameLimiter.setEnabled(false);
 
+	_clock.reset();
 	_isRunning = true;
 }
 
@@ -65,12 +104,23 @@ void Engine::clear()
 	delete _entityManager;
 
 	_renderSystem->destroy();
+	_fixedStepSystems.clear();
 	_systems.clear();
+	_renderSystem = nullptr;
 
 	InputManager::clearEvents();
 	AssetManager::instance().clear();
 
-	SDL_DestroyWindow(_window);
+	if (_window != nullptr)
+	{
+		SDL_DestroyWindow(_window);
+	}
+
+	if (_offscreenSurface != nullptr)
+	{
+		SDL_FreeSurface(_offscreenSurface);
+	}
+
 	SDL_Quit();
 
 	deleteInstance();
@@ -78,10 +128,13 @@ void Engine::clear()
 
 void Engine::handleEvents()
 {
-	_deltaTime = static_cast<float>(SDL_GetTicks() - _lastFrameTime) / 1000.f;
-	_lastFrameTime = SDL_GetTicks();
+	PROFILE_FUNCTION();
 
-	_fps = static_cast<unsigned int>(1 / _deltaTime);
+	_clock.tick();
+	_frameStats.beginFrame();
+	AllocationTracker::beginFrame();
+
+	FrameStats::ScopedTimer eventsTimer(_frameStats, "Events");
 
 	SDL_Event event;
 	while (SDL_PollEvent(&event))
@@ -100,6 +153,18 @@ void Engine::handleEvents()
 			}
 		}
 
+		if (event.type == SDL_WINDOWEVENT)
+		{
+			_frameLimiter.handleWindowEvent(event.window);
+		}
+
+		// Render target contents are lost with the device, so cached layers have to be redrawn
+		if (event.type == SDL_RENDER_TARGETS_RESET || event.type == SDL_RENDER_DEVICE_RESET)
+		{
+			_renderSystem->invalidateStaticLayers();
+			_tilemapSystem->invalidateChunks();
+		}
+
 		if (event.type == SDL_QUIT)
 		{
 			quit();
@@ -112,18 +177,247 @@ void Engine::handleEvents()
 
 void Engine::update()
 {
-	_spriteSystem->update();
-	_textSystem->update();
-	_animationSystem->update();
-	_buttonSystem->update();
+	PROFILE_FUNCTION();
 
-	_entityManager->refresh();
-	InputManager::clearFrameEvents();
+	bool stepped = false;
+	while (_clock.consumeFixedStep())
+	{
+		// Debug primitives of the last step stay up until a new step replaces them
+		if (!stepped)
+		{
+			DEBUG_DRAW_CLEAR();
+			stepped = true;
+		}
+
+		fixedUpdate();
+	}
+
+	// Buttons and removed entities are handled every rendered frame, so they keep working
+	// while the clock is paused, the time scale is 0 or the frame ran no step
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "ButtonSystem");
+		_buttonSystem->update();
+	}
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "EntityManager::refresh");
+		_entityManager->refresh();
+	}
+
+	// Pressed keys and buttons are only read by the steps, so they stay latched through frames without one
+	if (stepped)
+	{
+		InputManager::clearFrameEvents();
+	}
+
+	updateStatsOverlay();
+
+	// Sprites, texts, tilemaps, particles and shapes are placed once per rendered frame, interpolated between the last two steps
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "SpriteSystem");
+		_spriteSystem->update();
+	}
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "TextSystem");
+		_textSystem->update();
+	}
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "TilemapSystem");
+		_tilemapSystem->update();
+	}
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "ParticleSystem");
+		_particleSystem->update();
+	}
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "ShapeSystem");
+		_shapeSystem->update();
+	}
+
+	// Everything allocated from the arena two frames ago is released here
+	_frameArena.nextFrame();
+}
+
+void Engine::fixedUpdate()
+{
+	PROFILE_FUNCTION();
+
+	for (auto& entity : _entityManager->getEntitiesWithComponentAll<Transform>(_frameArena, true, true))
+	{
+		entity->getComponent<Transform>().storePreviousState();
+	}
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "AnimationSystem");
+		_animationSystem->update();
+	}
+
+	for (const FixedStepSystem& fixedStepSystem : _fixedStepSystems)
+	{
+		FrameStats::ScopedTimer timer(_frameStats, fixedStepSystem.name);
+		ALLOCATION_TAG(fixedStepSystem.name);
+		fixedStepSystem.system->fixedUpdate();
+	}
+
+}
+
+const char* Engine::systemName(const std::type_info& type)
+{
+	std::string name = type.name();
+
+#ifdef __GNUG__
+	int status = 0;
+	char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+	if (status == 0 && demangled != nullptr)
+	{
+		name = demangled;
+	}
+	free(demangled);
+#else
+	// MSVC names are readable already, apart from the class keyword
+	for (const char* prefix : { "class ", "struct " })
+	{
+		if (name.compare(0, std::strlen(prefix), prefix) == 0)
+		{
+			name.erase(0, std::strlen(prefix));
+		}
+	}
+#endif
+
+	// Reuse the name of a system type created before, e.g. by an earlier init
+	for (const std::string& existing : _systemNames)
+	{
+		if (existing == name)
+		{
+			return existing.c_str();
+		}
+	}
+
+	_systemNames.emplace_back(std::move(name));
+	return _systemNames.back().c_str();
 }
 
 void Engine::render()
 {
-	_renderSystem->update();
+	PROFILE_FUNCTION();
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "RenderSystem");
+		_renderSystem->update();
+	}
+
+	{
+		FrameStats::ScopedTimer timer(_frameStats, "FrameLimiter");
+		_frameLimiter.wait();
+	}
+}
+
+std::unique_lock<std::recursive_mutex> Engine::lockRenderer()
+{
+	// Assets are released after the render system when the engine is cleared
+	if (_renderSystem == nullptr)
+	{
+		return std::unique_lock<std::recursive_mutex>();
+	}
+
+	return _renderSystem->lockRenderer();
+}
+
+void Engine::destroyTexture(SDL_Texture* texture)
+{
+	if (_renderSystem == nullptr)
+	{
+		SDL_DestroyTexture(texture);
+		return;
+	}
+
+	_renderSystem->destroyTexture(texture);
+}
+
+void Engine::setStatsOverlayEnabled(bool enabled, const std::string& fontID)
+{
+	if (_statsOverlay != nullptr)
+	{
+		_statsOverlay->destroy();
+		_statsOverlay = nullptr;
+	}
+
+	if (enabled)
+	{
+		_statsOverlayFontID = fontID;
+		_statsOverlay = &createEntity();
+		Text& overlayText = _statsOverlay->addComponent<Text>(_statsOverlayFontID, SDL_MAX_SINT32, " ", SDL_Color{ 255, 255, 255, 255 }, 800u);
+		overlayText.setGlyphRendering(true);
+		_lastStatsOverlayRefresh = 0.0;
+	}
+}
+
+void Engine::initWorld(int width, int height, int worldWidth, int worldHeight)
+{
+	_entityManager = new EntityManager();
+
+	_worldDimensions.x = static_cast<float>(worldWidth);
+	_worldDimensions.y = static_cast<float>(worldHeight);
+
+	Entity& cameraEntity = createEntity();
+	_mainCamera = &cameraEntity.addComponent<Camera>(SDL_Rect{ 0, 0, width, height });
+}
+
+void Engine::initSystems()
+{
+	_spriteSystem = &createSystem<SpriteSystem>();
+	_textSystem = &createSystem<TextSystem>();
+	_tilemapSystem = &createSystem<TilemapSystem>();
+	_particleSystem = &createSystem<ParticleSystem>();
+	_shapeSystem = &createSystem<ShapeSystem>();
+	_animationSystem = &createSystem<AnimationSystem>();
+	_buttonSystem = &createSystem<ButtonSystem>();
+}
+
+void Engine::updateStatsOverlay()
+{
+	if (_statsOverlay == nullptr)
+	{
+		return;
+	}
+
+	// Texts are placed in the world, so follow the main camera to stay in the corner of the screen
+	SDL_Rect camera = getCamera();
+	Transform& transform = _statsOverlay->getComponent<Transform>();
+	transform.position.x = static_cast<float>(camera.x + 8);
+	transform.position.y = static_cast<float>(camera.y + 8);
+	transform.resetInterpolation();
+
+	// Re-rasterizing the text every frame would show up in the stats themselves
+	if (_clock.unscaledTime() - _lastStatsOverlayRefresh >= 0.5)
+	{
+		std::string report = "FPS " + std::to_string(_clock.FPS()) + "\n" + _frameStats.report();
+
+		const DrawStats& drawStats = _renderSystem->drawStats();
+		report += "Draw calls " + std::to_string(drawStats.drawCalls) + "  batches " + std::to_string(drawStats.batches) + "  texture switches " + std::to_string(drawStats.textureSwitches) + "\n";
+
+		if (_renderSystem->dynamicResolution().isEnabled())
+		{
+			report += "Resolution " + std::to_string(static_cast<int>(std::round(_renderSystem->dynamicResolution().scale() * 100.f))) + "%\n";
+		}
+
+		if (drawStats.occludedCommands > 0u)
+		{
+			report += "Occluded " + std::to_string(drawStats.occludedCommands) + "  " + std::to_string(drawStats.occludedPixels) + " pixels saved\n";
+		}
+
+		if (AllocationTracker::isEnabled())
+		{
+			AllocationTracker::Counters allocations = AllocationTracker::lastFrame();
+			report += "Allocations " + std::to_string(allocations.allocations) + "  " + std::to_string(allocations.bytes) + " bytes\n";
+		}
+		_statsOverlay->getComponent<Text>().setText(_statsOverlayFontID, report);
+		_lastStatsOverlayRefresh = _clock.unscaledTime();
+	}
 }
 
 Entity& Engine::createEntity()
@@ -134,6 +428,21 @@ Entity& Engine::createEntity()
 	return newEntity;
 }
 
+Vector2 Engine::screenToWorld(const Vector2& screenPosition)
+{
+	Camera* topmost = nullptr;
+	for (auto& cameraEntity : _entityManager->getEntitiesWithComponentAll<Camera>(_frameArena))
+	{
+		Camera& camera = cameraEntity->getComponent<Camera>();
+		if (camera.viewportContains(screenPosition) && (topmost == nullptr || camera.getOrder() >= topmost->getOrder()))
+		{
+			topmost = &camera;
+		}
+	}
+
+	return (topmost != nullptr ? topmost : _mainCamera)->screenToWorld(screenPosition);
+}
+
 Entity& Engine::createEmptyEntity()
 {
 	Entity& newEntity = _entityManager->createEntity();
@@ -1,16 +1,27 @@
 #pragma once
 
-#include <vector>
+#include <deque>
 #include <memory>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
 
 #include "ECS/ECS.h"
 #include "Singleton.h"
+#include "Clock.h"
+#include "FrameLimiter.h"
+#include "Profiling/FrameStats.h"
 #include "ECS/Systems/RenderSystem.h"
+#include "ECS/Components/Camera.h"
 #include "Math/Vector2.h"
 #include "ECS/Systems/SpriteSystem.h"
 #include "ECS/Systems/AnimationSystem.h"
 #include "ECS/Systems/ButtonSystem.h"
 #include "ECS/Systems/TextSystem.h"
+#include "ECS/Systems/TilemapSystem.h"
+#include "ECS/Systems/ParticleSystem.h"
+#include "ECS/Systems/ShapeSystem.h"
 
 class Engine : public Singleton<Engine>
 {
@@ -26,11 +37,21 @@ public:
 	/// <param name="width">The width of the window</param>
 	/// <param name="height">The height of the window</param>
 	/// <param name="fullscreen">Flag to set the window fullscreen or not</param>
-	/// <param name="vsync">Flag to enable vsync or not</param>
+	/// <param name="vsync">Flag to enable vsync or not. Without vsync, frames are paced by the frame limiter</param>
 	/// <param name="worldWidth">The width of the game world</param>
 	/// <param name="worldHeight">The height of the game world</param>
 	void init(const char* title, int width, int height, bool fullscreen, bool vsync, int worldWidth, int worldHeight);
 
+	/// <summary>
+	/// Initializes the engine without a window, rendering through SDL's software renderer into an offscreen surface.
+	/// Used to run render benchmarks on machines without a display or GPU. The frame limiter is disabled.
+	/// </summary>
+	/// <param name="width">The width of the offscreen surface</param>
+	/// <param name="height">The height of the offscreen surface</param>
+	/// <param name="worldWidth">The width of the game world</param>
+	/// <param name="worldHeight">The height of the game world</param>
+	void initHeadless(int width, int height, int worldWidth, int worldHeight);
+
 	/// <summary>
 	/// Stops the engine.
 	/// </summary>
@@ -47,12 +68,15 @@ public:
 	void handleEvents();
 
 	/// <summary>
-	/// Updates the engine every frame
+	/// Updates the engine every frame.
+	/// Runs as many fixed simulation steps as the elapsed time requires, handles buttons and removed entities
+	/// once per frame, then prepares the interpolated state for rendering. Pressed keys and buttons are kept until a step ran.
 	/// </summary>
 	void update();
 
 	/// <summary>
-	/// Calls the update call to the Render System
+	/// Calls the update call to the Render System, which extracts the frame and draws it or hands it to the render thread,
+	/// and waits for the frame limiter
 	/// </summary>
 	void render();
 
@@ -72,9 +96,10 @@ public:
 	/// Creates a new System.
 	/// </summary>
 	/// <typeparam name="T"></typeparam>
+	/// <param name="name">The name the fixed steps of the system are timed and tagged under, its type name if null</param>
 	/// <returns>A reference to the newly-created system</returns>
 	template<typename T>
-	T& createSystem()
+	T& createSystem(const char* name = nullptr)
 	{
 		static_assert(std::is_base_of<System, T>::value, "Type must be derived from System!");
 		//T* system = new T(_entityManager);
@@ -86,6 +111,12 @@ public:
 
 		_systems.emplace_back(std::move(systemUniqPtr));
 
+		// Only systems that override fixedUpdate have fixed-step work to run and time
+		if (!std::is_same<decltype(&T::fixedUpdate), void (System::*)()>::value)
+		{
+			_fixedStepSystems.emplace_back(FixedStepSystem{ system, name != nullptr ? name : systemName(typeid(T)) });
+		}
+
 		return *system;
 	}
 
@@ -102,10 +133,133 @@ public:
 	inline SDL_Renderer* getRenderer() { return _renderSystem->SDLRenderer(); }
 
 	/// <summary>
-	/// Returns an SDL_Rect that defines the game camera.
+	/// Draws frames on a render thread, so the next frame is simulated while the last one is drawn.
+	/// Only for renderers that can be driven from another thread, like Direct3D and the software renderer, not OpenGL.
+	/// Code that calls into the renderer directly has to hold lockRenderer() while the thread runs.
+	/// </summary>
+	/// <param name="enabled">Flag to use the render thread or not</param>
+	inline void setRenderThreadEnabled(bool enabled) { _renderSystem->setRenderThreadEnabled(enabled); }
+
+	/// <summary>
+	/// Checks whether frames are drawn on the render thread.
 	/// </summary>
-	/// <returns>The game camera</returns>
-	inline SDL_Rect getCamera() { return _camera; }
+	/// <returns>True if they are, false if not</returns>
+	inline bool isRenderThreadEnabled() const { return _renderSystem->isRenderThreadEnabled(); }
+
+	/// <summary>
+	/// Locks the renderer against the render thread, for creating and updating textures.
+	/// </summary>
+	/// <returns>The lock, released when it goes out of scope</returns>
+	std::unique_lock<std::recursive_mutex> lockRenderer();
+
+	/// <summary>
+	/// Destroys a texture, or defers it until the frame on the render thread can't draw it anymore.
+	/// </summary>
+	/// <param name="texture">The texture to destroy</param>
+	void destroyTexture(SDL_Texture* texture);
+
+	/// <summary>
+	/// Returns the draw calls, texture switches and batches of the last rendered frame.
+	/// </summary>
+	/// <returns>The draw statistics</returns>
+	inline const DrawStats& drawStats() const { return _renderSystem->drawStats(); }
+
+	/// <summary>
+	/// Returns the dynamic resolution controller. Once enabled, the world is rendered at a lower resolution
+	/// while frames take longer than the target frame time, and stretched to the window.
+	/// </summary>
+	/// <returns>A reference to the dynamic resolution controller</returns>
+	inline DynamicResolution& dynamicResolution() { return _renderSystem->dynamicResolution(); }
+
+	/// <summary>
+	/// Returns the spatial grid used to cull renderables outside the camera.
+	/// </summary>
+	/// <returns>A reference to the spatial grid</returns>
+	inline SpatialGrid& spatialGrid() { return _renderSystem->spatialGrid(); }
+
+	/// <summary>
+	/// Registers a render layer at runtime. Layers are drawn from the lowest to the highest order,
+	/// the built-in layers have the orders 0 (Background), 100 (Midground), 200 (Foreground) and 300 (UI).
+	/// </summary>
+	/// <param name="name">The name of the layer</param>
+	/// <param name="order">Where the layer is drawn relative to the others</param>
+	/// <param name="sortMode">How the renderables of the layer are ordered</param>
+	/// <returns>The new layer, or the existing one if the name is taken</returns>
+	inline RenderLayer registerRenderLayer(const std::string& name, int order, LayerSortMode sortMode = LayerSortMode::Depth) { return _renderSystem->registerLayer(name, order, sortMode); }
+
+	/// <summary>
+	/// Finds a render layer by name.
+	/// </summary>
+	/// <param name="name">The name of the layer</param>
+	/// <returns>The layer, or RenderLayer::MaxLayers if none has the name</returns>
+	inline RenderLayer findRenderLayer(const std::string& name) const { return _renderSystem->findLayer(name); }
+
+	/// <summary>
+	/// Sets how the renderables of a layer are ordered before drawing, e.g. LayerSortMode::Y for top-down games.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="sortMode">The sort mode</param>
+	inline void setLayerSortMode(RenderLayer layer, LayerSortMode sortMode) { _renderSystem->setLayerSortMode(layer, sortMode); }
+
+	/// <summary>
+	/// Flags a render layer as static, so it is rendered once into cached tiles and only redrawn when something in it changes.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="isStatic">Flag to cache the layer or not</param>
+	inline void setLayerStatic(RenderLayer layer, bool isStatic) { _renderSystem->setLayerStatic(layer, isStatic); }
+
+	/// <summary>
+	/// Checks whether a render layer is cached as static.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isLayerStatic(RenderLayer layer) const { return _renderSystem->isLayerStatic(layer); }
+
+	/// <summary>
+	/// Marks an area of a static layer to be re-rendered.
+	/// </summary>
+	/// <param name="layer">The render layer</param>
+	/// <param name="area">The area in world coordinates</param>
+	inline void invalidateStaticLayer(RenderLayer layer, const SDL_Rect& area) { _renderSystem->invalidateStaticLayer(layer, area); }
+
+	/// <summary>
+	/// Returns the view of the main camera, created by the engine to cover the whole window.
+	/// </summary>
+	/// <returns>The view of the main camera in world coordinates</returns>
+	inline SDL_Rect getCamera() { return _mainCamera->worldView(); }
+
+	/// <summary>
+	/// Returns the main camera, created by the engine to cover the whole window.
+	/// Add Camera components to other entities for split-screen or a minimap.
+	/// </summary>
+	/// <returns>A reference to the main camera</returns>
+	inline Camera& mainCamera() { return *_mainCamera; }
+
+	/// <summary>
+	/// Moves the main camera without interpolating from its previous position.
+	/// </summary>
+	/// <param name="x">The X coordinate of the top left corner in world coordinates</param>
+	/// <param name="y">The Y coordinate of the top left corner in world coordinates</param>
+	inline void setCameraPosition(int x, int y)
+	{
+		Transform& transform = _mainCamera->getTransform();
+		transform.position.x = static_cast<float>(x);
+		transform.position.y = static_cast<float>(y);
+		transform.resetInterpolation();
+	}
+
+	/// <summary>
+	/// Converts a point on the screen to world coordinates, through the topmost camera whose viewport contains it.
+	/// </summary>
+	/// <param name="screenPosition">The point in screen coordinates</param>
+	/// <returns>The point in world coordinates</returns>
+	Vector2 screenToWorld(const Vector2& screenPosition);
+
+	/// <summary>
+	/// Returns the offscreen surface rendered to by a headless engine.
+	/// </summary>
+	/// <returns>A pointer to the surface, or nullptr if the engine renders to a window</returns>
+	inline SDL_Surface* offscreenSurface() { return _offscreenSurface; }
 
 	/// <summary>
 	/// Returns the dimensions of the game world.
@@ -117,33 +271,116 @@ public:
 	/// Returns the time difference between this frame and the last.
 	/// </summary>
 	/// <returns>The time difference between this frame and the last</returns>
-	inline float deltaTime() { return _deltaTime; }
+	inline float deltaTime() { return _clock.deltaTime(); }
+
+	/// <summary>
+	/// Returns the duration of a fixed simulation step.
+	/// </summary>
+	/// <returns>The fixed step duration in seconds</returns>
+	inline float fixedDeltaTime() { return _clock.fixedDeltaTime(); }
 
 	/// <summary>
 	/// Returns the frames per second
 	/// </summary>
 	/// <returns>Frames per second</returns>
-	inline unsigned int FPS() { return _fps; }
+	inline unsigned int FPS() { return _clock.FPS(); }
+
+	/// <summary>
+	/// Returns the engine clock, used to control the fixed step rate, time scale and pause.
+	/// </summary>
+	/// <returns>A reference to the engine clock</returns>
+	inline Clock& clock() { return _clock; }
+
+	/// <summary>
+	/// Returns the frame limiter, used to set the target frame rate and read frame pacing stats.
+	/// </summary>
+	/// <returns>A reference to the frame limiter</returns>
+	inline FrameLimiter& frameLimiter() { return _frameLimiter; }
+
+	/// <summary>
+	/// Returns the rolling frame time statistics, with a channel per engine system.
+	/// </summary>
+	/// <returns>A reference to the frame statistics</returns>
+	inline FrameStats& frameStats() { return _frameStats; }
+
+	/// <summary>
+	/// Returns the frame arena, used by systems for transient per-frame memory.
+	/// Memory allocated from it stays valid until the end of the next frame's update.
+	/// </summary>
+	/// <returns>A reference to the frame arena</returns>
+	inline FrameArena& frameArena() { return _frameArena; }
+
+	/// <summary>
+	/// Shows or hides an on-screen overlay with the frame time statistics.
+	/// </summary>
+	/// <param name="enabled">Flag to show the overlay or not</param>
+	/// <param name="fontID">The ID of a loaded font used to draw the overlay</param>
+	void setStatsOverlayEnabled(bool enabled, const std::string& fontID = "");
 
 private:
 	bool _isRunning = false;
 
-	unsigned int _lastFrameTime = 0u;
-	unsigned int _lastFPSCountTime = 0u;
-	float _deltaTime = 1.f;
+	Clock _clock;
+	FrameLimiter _frameLimiter;
+	FrameStats _frameStats;
+	FrameArena _frameArena;
 
-	unsigned int _fps = 0;
+	Entity* _statsOverlay = nullptr;
+	std::string _statsOverlayFontID;
+	double _lastStatsOverlayRefresh = 0.0;
 
 	SDL_Window* _window = nullptr;
-	SDL_Rect _camera = { 0, 0, 0, 0 };
+	SDL_Surface* _offscreenSurface = nullptr;
+	Camera* _mainCamera = nullptr;
 	Vector2 _worldDimensions;
 	RenderSystem* _renderSystem = nullptr;
 	EntityManager* _entityManager = nullptr;
 
 	SpriteSystem* _spriteSystem = nullptr;
 	TextSystem* _textSystem = nullptr;
+	TilemapSystem* _tilemapSystem = nullptr;
+	ParticleSystem* _particleSystem = nullptr;
+	ShapeSystem* _shapeSystem = nullptr;
 	AnimationSystem* _animationSystem = nullptr;
 	ButtonSystem* _buttonSystem = nullptr;
 
+	// A system with fixed-step work and the name it is timed under
+	struct FixedStepSystem
+	{
+		System* system;
+		const char* name;
+	};
+
 	std::vector<std::unique_ptr<System>> _systems;
+	std::vector<FixedStepSystem> _fixedStepSystems;
+
+	// Frame statistics keep channel names by pointer, so generated names live as long as the engine
+	std::deque<std::string> _systemNames;
+
+	/// <summary>
+	/// Returns a readable name for a system type, without the mangling or class prefix the compiler adds.
+	/// </summary>
+	/// <param name="type">The type of the system</param>
+	/// <returns>The name, valid as long as the engine</returns>
+	const char* systemName(const std::type_info& type);
+
+	/// <summary>
+	/// Creates the entity manager and sets up the camera and world dimensions.
+	/// </summary>
+	void initWorld(int width, int height, int worldWidth, int worldHeight);
+
+	/// <summary>
+	/// Creates the built-in systems that run after the Render System.
+	/// </summary>
+	void initSystems();
+
+	/// <summary>
+	/// Runs a single fixed simulation step.
+	/// </summary>
+	void fixedUpdate();
+
+	/// <summary>
+	/// Refreshes the text of the stats overlay and keeps it pinned to the camera.
+	/// </summary>
+	void updateStatsOverlay();
 };
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "FrameLimiter.h"
+#include <cmath>
+#include "Profiling/Profiler.h"
+
+// Smoothing factor for the frame time average and variance
+constexpr double STATS_SMOOTHING = 0.05;
+
+constexpr double MIN_SPIN_THRESHOLD = 0.0005;
+constexpr double MAX_SPIN_THRESHOLD = 0.004;
+
+FrameLimiter::FrameLimiter()
+{
+	_frequency = SDL_GetPerformanceFrequency();
+	_frameStart = SDL_GetPerformanceCounter();
+}
+
+void FrameLimiter::setTargetFrameRate(double framesPerSecond)
+{
+	if (framesPerSecond > 0.0)
+	{
+		_targetFrameTime = 1.0 / framesPerSecond;
+	}
+}
+
+void FrameLimiter::setUnfocusedFrameRate(double framesPerSecond)
+{
+	if (framesPerSecond > 0.0)
+	{
+		_unfocusedFrameTime = 1.0 / framesPerSecond;
+	}
+}
+
+void FrameLimiter::setOccludedFrameRate(double framesPerSecond)
+{
+	if (framesPerSecond > 0.0)
+	{
+		_occludedFrameTime = 1.0 / framesPerSecond;
+	}
+}
+
+void FrameLimiter::handleWindowEvent(const SDL_WindowEvent& event)
+{
+	switch (event.event)
+	{
+	case SDL_WINDOWEVENT_FOCUS_GAINED:
+		_focused = true;
+		break;
+
+	case SDL_WINDOWEVENT_FOCUS_LOST:
+		_focused = false;
+		break;
+
+	case SDL_WINDOWEVENT_HIDDEN:
+	case SDL_WINDOWEVENT_MINIMIZED:
+		_occluded = true;
+		break;
+
+	case SDL_WINDOWEVENT_SHOWN:
+	case SDL_WINDOWEVENT_EXPOSED:
+	case SDL_WINDOWEVENT_RESTORED:
+		_occluded = false;
+		break;
+
+	default:
+		break;
+	}
+}
+
+double FrameLimiter::targetFrameTime() const
+{
+	if (_throttleInBackground)
+	{
+		if (_occluded)
+		{
+			return _occludedFrameTime;
+		}
+
+		if (!_focused)
+		{
+			return _unfocusedFrameTime;
+		}
+	}
+
+	return _enabled ? _targetFrameTime : 0.0;
+}
+
+void FrameLimiter::wait()
+{
+	PROFILE_FUNCTION();
+
+	double target = targetFrameTime();
+	Uint64 deadline = _frameStart + static_cast<Uint64>(target * _frequency);
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	_stats.workTime = static_cast<double>(now - _frameStart) / _frequency;
+
+	if (target > 0.0 && now < deadline)
+	{
+		double remaining = static_cast<double>(deadline - now) / _frequency;
+
+		if (remaining > _spinThreshold)
+		{
+			Uint32 sleepMs = static_cast<Uint32>((remaining - _spinThreshold) * 1000.0);
+
+			if (sleepMs > 0u)
+			{
+				SDL_Delay(sleepMs);
+
+				// Learn how much the scheduler oversleeps and keep that much time for spinning
+				Uint64 afterSleep = SDL_GetPerformanceCounter();
+				double oversleep = static_cast<double>(afterSleep - now) / _frequency - sleepMs / 1000.0;
+				double threshold = _spinThreshold + (oversleep - _spinThreshold) * 0.1;
+				_spinThreshold = SDL_max(MIN_SPIN_THRESHOLD, SDL_min(threshold, MAX_SPIN_THRESHOLD));
+			}
+		}
+
+		while (SDL_GetPerformanceCounter() < deadline)
+		{
+			// Spin for the last fraction of a millisecond
+		}
+
+		now = SDL_GetPerformanceCounter();
+	}
+
+	recordFrame(static_cast<double>(now - _frameStart) / _frequency, target);
+
+	// Schedule from the deadline so small overshoots don't accumulate into drift,
+	// but restart from now if we fell behind to avoid rushing the following frames
+	bool onTime = target > 0.0 && now - deadline < static_cast<Uint64>(target * _frequency);
+	_frameStart = onTime ? deadline : now;
+}
+
+void FrameLimiter::resetStats()
+{
+	_stats = Stats();
+	_frameTimeVariance = 0.0;
+}
+
+void FrameLimiter::recordFrame(double frameTime, double target)
+{
+	_stats.targetFrameTime = target;
+
+	if (_stats.frameCount == 0u)
+	{
+		_stats.averageFrameTime = frameTime;
+	}
+
+	double difference = frameTime - _stats.averageFrameTime;
+	_stats.averageFrameTime += STATS_SMOOTHING * difference;
+	_frameTimeVariance = (1.0 - STATS_SMOOTHING) * (_frameTimeVariance + STATS_SMOOTHING * difference * difference);
+	_stats.jitter = std::sqrt(_frameTimeVariance);
+
+	if (target > 0.0)
+	{
+		double deviation = std::abs(frameTime - target);
+		_stats.maxDeviation = deviation > _stats.maxDeviation ? deviation : _stats.maxDeviation;
+
+		if (frameTime > target * 1.05)
+		{
+			++_stats.missedFrames;
+		}
+	}
+
+	++_stats.frameCount;
+}
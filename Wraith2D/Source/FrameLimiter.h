@@ -0,0 +1,136 @@
+#pragma once
+
+#include <SDL.h>
+
+class FrameLimiter
+{
+public:
+	struct Stats
+	{
+		/// <summary>
+		/// The frame time currently being targeted, in seconds. 0 when not limiting.
+		/// </summary>
+		double targetFrameTime = 0.0;
+
+		/// <summary>
+		/// Smoothed average of the measured frame time, in seconds.
+		/// </summary>
+		double averageFrameTime = 0.0;
+
+		/// <summary>
+		/// Smoothed standard deviation of the measured frame time, in seconds.
+		/// </summary>
+		double jitter = 0.0;
+
+		/// <summary>
+		/// Time the last frame spent working before the limiter started waiting, in seconds.
+		/// </summary>
+		double workTime = 0.0;
+
+		/// <summary>
+		/// Largest difference between a measured frame time and its target since the stats were reset, in seconds.
+		/// </summary>
+		double maxDeviation = 0.0;
+
+		/// <summary>
+		/// Number of frames that finished after their deadline since the stats were reset.
+		/// </summary>
+		unsigned int missedFrames = 0u;
+
+		/// <summary>
+		/// Number of frames measured since the stats were reset.
+		/// </summary>
+		unsigned int frameCount = 0u;
+	};
+
+	FrameLimiter();
+
+	/// <summary>
+	/// Enables or disables limiting while the window is focused and visible.
+	/// Throttling in the background is controlled separately.
+	/// </summary>
+	/// <param name="enabled">The new enabled state</param>
+	inline void setEnabled(bool enabled) { _enabled = enabled; }
+
+	/// <summary>
+	/// Checks whether limiting is enabled while the window is focused and visible.
+	/// </summary>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isEnabled() const { return _enabled; }
+
+	/// <summary>
+	/// Sets the frame rate targeted while the window is focused.
+	/// </summary>
+	/// <param name="framesPerSecond">The target frame rate</param>
+	void setTargetFrameRate(double framesPerSecond);
+
+	/// <summary>
+	/// Sets the frame rate targeted while the window is unfocused.
+	/// </summary>
+	/// <param name="framesPerSecond">The target frame rate</param>
+	void setUnfocusedFrameRate(double framesPerSecond);
+
+	/// <summary>
+	/// Sets the frame rate targeted while the window is hidden or fully covered.
+	/// </summary>
+	/// <param name="framesPerSecond">The target frame rate</param>
+	void setOccludedFrameRate(double framesPerSecond);
+
+	/// <summary>
+	/// Enables or disables the automatic throttling when the window is unfocused or occluded.
+	/// </summary>
+	/// <param name="throttle">The new throttle state</param>
+	inline void setThrottleInBackground(bool throttle) { _throttleInBackground = throttle; }
+
+	/// <summary>
+	/// Tracks window focus and visibility changes.
+	/// </summary>
+	/// <param name="event">The window event</param>
+	void handleWindowEvent(const SDL_WindowEvent& event);
+
+	/// <summary>
+	/// Blocks until the current frame reaches its target duration.
+	/// Sleeps for most of the remaining time and spins for the last stretch, since sleeping is too coarse to hit the deadline.
+	/// Should be called once per frame, right after presenting.
+	/// </summary>
+	void wait();
+
+	/// <summary>
+	/// Returns the frame time currently being targeted.
+	/// </summary>
+	/// <returns>The target frame time in seconds, or 0 if frames are not being limited</returns>
+	double targetFrameTime() const;
+
+	/// <summary>
+	/// Returns the frame pacing statistics.
+	/// </summary>
+	/// <returns>The statistics</returns>
+	inline const Stats& stats() const { return _stats; }
+
+	/// <summary>
+	/// Resets the frame pacing statistics.
+	/// </summary>
+	void resetStats();
+
+private:
+	bool _enabled = false;
+	bool _throttleInBackground = true;
+	bool _focused = true;
+	bool _occluded = false;
+
+	double _targetFrameTime = 1.0 / 60.0;
+	double _unfocusedFrameTime = 1.0 / 20.0;
+	double _occludedFrameTime = 1.0 / 5.0;
+
+	// Time left before the deadline at which the limiter stops sleeping and starts spinning.
+	// Adapts to how much the OS oversleeps.
+	double _spinThreshold = 0.002;
+
+	Uint64 _frequency = 1u;
+	Uint64 _frameStart = 0u;
+
+	Stats _stats;
+	double _frameTimeVariance = 0.0;
+
+	void recordFrame(double frameTime, double target);
+};
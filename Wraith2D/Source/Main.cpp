@@ -1,7 +1,34 @@
+#include <cstring>
+#include <iostream>
+
 #include "Engine.h"
 #include "InputManager.h"
+#include "Profiling/RenderBenchmark.h"
 
 int main(int argc, char* argv[])
 {	
+	bool renderThread = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--render-thread") == 0)
+		{
+			renderThread = true;
+		}
+	}
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--render-benchmark") == 0)
+		{
+			Engine::instance().initHeadless(1280, 720, 8192, 8192);
+
+			RenderBenchmark::Settings settings;
+			settings.renderThread = renderThread;
+			RenderBenchmark::print(std::cout, RenderBenchmark::run(settings));
+
+			Engine::instance().clear();
+		}
+	}
+
 	return 0;
 }
@@ -0,0 +1,103 @@
+#include "TransformKernel.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WRAITH2D_SSE2
+#include <emmintrin.h>
+#endif
+
+static_assert(sizeof(SDL_Rect) == 4 * sizeof(int), "Rects are stored as four packed ints");
+
+namespace
+{
+	// Adding half with the sign of the value then truncating rounds half away from zero, like std::round,
+	// and is done the same way in both paths so they give identical rects
+	inline int roundToInt(float value)
+	{
+		return static_cast<int>(value + (value < 0.f ? -0.5f : 0.5f));
+	}
+
+#ifdef WRAITH2D_SSE2
+	inline __m128i roundToInt(__m128 values)
+	{
+		__m128 half = _mm_or_ps(_mm_and_ps(values, _mm_set1_ps(-0.f)), _mm_set1_ps(0.5f));
+		return _mm_cvttps_epi32(_mm_add_ps(values, half));
+	}
+#endif
+}
+
+void TransformKernel::clear()
+{
+	_positionX.clear();
+	_positionY.clear();
+	_scaleX.clear();
+	_scaleY.clear();
+	_offsetX.clear();
+	_offsetY.clear();
+	_width.clear();
+	_height.clear();
+}
+
+void TransformKernel::reserve(std::size_t count)
+{
+	_positionX.reserve(count);
+	_positionY.reserve(count);
+	_scaleX.reserve(count);
+	_scaleY.reserve(count);
+	_offsetX.reserve(count);
+	_offsetY.reserve(count);
+	_width.reserve(count);
+	_height.reserve(count);
+}
+
+void TransformKernel::run(SDL_Rect* rects) const
+{
+	std::size_t count = size();
+	std::size_t i = 0u;
+
+#ifdef WRAITH2D_SSE2
+	for (; i + 4u <= count; i += 4u)
+	{
+		__m128 scaleX = _mm_loadu_ps(&_scaleX[i]);
+		__m128 scaleY = _mm_loadu_ps(&_scaleY[i]);
+
+		__m128i x = roundToInt(_mm_add_ps(_mm_loadu_ps(&_positionX[i]), _mm_mul_ps(_mm_loadu_ps(&_offsetX[i]), scaleX)));
+		__m128i y = roundToInt(_mm_add_ps(_mm_loadu_ps(&_positionY[i]), _mm_mul_ps(_mm_loadu_ps(&_offsetY[i]), scaleY)));
+		__m128i w = roundToInt(_mm_mul_ps(_mm_loadu_ps(&_width[i]), scaleX));
+		__m128i h = roundToInt(_mm_mul_ps(_mm_loadu_ps(&_height[i]), scaleY));
+
+		// Transpose the x, y, w and h lanes into four packed rects
+		__m128i xy01 = _mm_unpacklo_epi32(x, y);
+		__m128i xy23 = _mm_unpackhi_epi32(x, y);
+		__m128i wh01 = _mm_unpacklo_epi32(w, h);
+		__m128i wh23 = _mm_unpackhi_epi32(w, h);
+
+		__m128i* out = reinterpret_cast<__m128i*>(rects + i);
+		_mm_storeu_si128(out, _mm_unpacklo_epi64(xy01, wh01));
+		_mm_storeu_si128(out + 1, _mm_unpackhi_epi64(xy01, wh01));
+		_mm_storeu_si128(out + 2, _mm_unpacklo_epi64(xy23, wh23));
+		_mm_storeu_si128(out + 3, _mm_unpackhi_epi64(xy23, wh23));
+	}
+#endif
+
+	runScalar(i, count, rects);
+}
+
+bool TransformKernel::isVectorized()
+{
+#ifdef WRAITH2D_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+void TransformKernel::runScalar(std::size_t begin, std::size_t end, SDL_Rect* rects) const
+{
+	for (std::size_t i = begin; i < end; i++)
+	{
+		rects[i].x = roundToInt(_positionX[i] + _offsetX[i] * _scaleX[i]);
+		rects[i].y = roundToInt(_positionY[i] + _offsetY[i] * _scaleY[i]);
+		rects[i].w = roundToInt(_width[i] * _scaleX[i]);
+		rects[i].h = roundToInt(_height[i] * _scaleY[i]);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+#include "Vector2.h"
+
+/// <summary>
+/// Computes destination rects for many renderables at once.
+/// Inputs are gathered into one contiguous float array per attribute, so the rects can be computed four at a time with SSE2.
+/// Targets without SSE2 use a scalar loop that gives the same results.
+/// </summary>
+class TransformKernel
+{
+public:
+	/// <summary>
+	/// Removes every input, keeping the allocated memory for the next frame.
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Reserves memory for a number of inputs.
+	/// </summary>
+	/// <param name="count">The number of inputs</param>
+	void reserve(std::size_t count);
+
+	/// <summary>
+	/// Adds the input for one rect.
+	/// </summary>
+	/// <param name="position">The position of the Transform</param>
+	/// <param name="scale">The scale of the Transform</param>
+	/// <param name="offset">The unscaled offset relative to the Transform</param>
+	/// <param name="width">The unscaled width</param>
+	/// <param name="height">The unscaled height</param>
+	inline void add(const Vector2& position, const Vector2& scale, const Vector2& offset, float width, float height)
+	{
+		_positionX.emplace_back(position.x);
+		_positionY.emplace_back(position.y);
+		_scaleX.emplace_back(scale.x);
+		_scaleY.emplace_back(scale.y);
+		_offsetX.emplace_back(offset.x);
+		_offsetY.emplace_back(offset.y);
+		_width.emplace_back(width);
+		_height.emplace_back(height);
+	}
+
+	/// <summary>
+	/// Returns the number of inputs.
+	/// </summary>
+	/// <returns>The number of inputs</returns>
+	inline std::size_t size() const { return _positionX.size(); }
+
+	/// <summary>
+	/// Computes a rect for every input, in the order they were added: the position plus the scaled offset,
+	/// and the scaled size, each rounded half away from zero.
+	/// </summary>
+	/// <param name="rects">Receives the rects, must hold size() of them</param>
+	void run(SDL_Rect* rects) const;
+
+	/// <summary>
+	/// Checks whether the kernel was compiled with SSE2.
+	/// </summary>
+	/// <returns>True if it was, false if it runs the scalar loop</returns>
+	static bool isVectorized();
+
+private:
+	std::vector<float> _positionX;
+	std::vector<float> _positionY;
+	std::vector<float> _scaleX;
+	std::vector<float> _scaleY;
+	std::vector<float> _offsetX;
+	std::vector<float> _offsetY;
+	std::vector<float> _width;
+	std::vector<float> _height;
+
+	void runScalar(std::size_t begin, std::size_t end, SDL_Rect* rects) const;
+};
@@ -0,0 +1,84 @@
+#include "FrameArena.h"
+
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t capacity)
+{
+	for (auto& buffer : _buffers)
+	{
+		buffer.memory = std::make_unique<std::byte[]>(capacity);
+		buffer.capacity = capacity;
+	}
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+	Buffer& buffer = _buffers[_current];
+	uintptr_t base = reinterpret_cast<uintptr_t>(buffer.memory.get());
+
+	// Bump the offset with a CAS so several threads can allocate from the same frame without locking
+	std::size_t offset = buffer.offset.load(std::memory_order_relaxed);
+	std::size_t alignedOffset = 0u;
+
+	do
+	{
+		alignedOffset = ((base + offset + alignment - 1u) & ~(alignment - 1u)) - base;
+
+		if (alignedOffset + size > buffer.capacity)
+		{
+			return allocateOverflow(buffer, size, alignment);
+		}
+	} while (!buffer.offset.compare_exchange_weak(offset, alignedOffset + size, std::memory_order_relaxed));
+
+	return buffer.memory.get() + alignedOffset;
+}
+
+void FrameArena::nextFrame()
+{
+	Buffer& finished = _buffers[_current];
+	std::size_t finishedBytes = finished.offset.load(std::memory_order_relaxed) + finished.overflowBytes;
+	_highWaterMark = finishedBytes > _highWaterMark ? finishedBytes : _highWaterMark;
+
+	_current ^= 1u;
+
+	// The buffer we switch to was last used two frames ago, nothing can reference it anymore
+	Buffer& buffer = _buffers[_current];
+
+	if (buffer.overflowBytes > 0u)
+	{
+		// Grow so the frame that overflowed fits next time
+		std::size_t newCapacity = (buffer.capacity + buffer.overflowBytes) * 3u / 2u;
+
+		buffer.memory = std::make_unique<std::byte[]>(newCapacity);
+		buffer.capacity = newCapacity;
+		buffer.overflow.clear();
+		buffer.overflowBytes = 0u;
+
+		_growCount++;
+	}
+
+	buffer.offset.store(0u, std::memory_order_relaxed);
+}
+
+std::size_t FrameArena::used() const
+{
+	const Buffer& buffer = _buffers[_current];
+	return buffer.offset.load(std::memory_order_relaxed) + buffer.overflowBytes;
+}
+
+std::size_t FrameArena::capacity() const
+{
+	return _buffers[_current].capacity;
+}
+
+void* FrameArena::allocateOverflow(Buffer& buffer, std::size_t size, std::size_t alignment)
+{
+	std::lock_guard<std::mutex> lock(_overflowMutex);
+
+	std::size_t blockSize = size + alignment - 1u;
+	buffer.overflow.emplace_back(std::make_unique<std::byte[]>(blockSize));
+	buffer.overflowBytes += blockSize;
+
+	uintptr_t address = reinterpret_cast<uintptr_t>(buffer.overflow.back().get());
+	return reinterpret_cast<void*>((address + alignment - 1u) & ~static_cast<uintptr_t>(alignment - 1u));
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class FrameArena
+{
+public:
+	/// <summary>
+	/// Creates a frame arena.
+	/// </summary>
+	/// <param name="capacity">The size in bytes of each of the two frame buffers</param>
+	FrameArena(std::size_t capacity = 4u * 1024u * 1024u);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	/// <summary>
+	/// Allocates transient memory from the current frame buffer. Safe to call from any thread.
+	/// The memory stays valid until the end of the NEXT frame, so it can be handed to a render thread.
+	/// </summary>
+	/// <param name="size">The number of bytes</param>
+	/// <param name="alignment">The alignment, must be a power of two</param>
+	/// <returns>A pointer to the memory</returns>
+	void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+	/// <summary>
+	/// Allocates an uninitialized array from the current frame buffer.
+	/// </summary>
+	/// <typeparam name="T">The element type. Destructors are never run</typeparam>
+	/// <param name="count">The number of elements</param>
+	/// <returns>A pointer to the first element</returns>
+	template<typename T>
+	T* allocateArray(std::size_t count)
+	{
+		return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+	}
+
+	/// <summary>
+	/// Switches to the other frame buffer and resets it, releasing everything allocated two frames ago.
+	/// Called by the Engine at the end of every update.
+	/// </summary>
+	void nextFrame();
+
+	/// <summary>
+	/// Returns the number of bytes allocated from the current frame buffer.
+	/// </summary>
+	/// <returns>The number of bytes used</returns>
+	std::size_t used() const;
+
+	/// <summary>
+	/// Returns the size of each frame buffer. Grows when a frame overflows it.
+	/// </summary>
+	/// <returns>The capacity in bytes</returns>
+	std::size_t capacity() const;
+
+	/// <summary>
+	/// Returns the largest number of bytes a single frame has requested.
+	/// </summary>
+	/// <returns>The high water mark in bytes</returns>
+	inline std::size_t highWaterMark() const { return _highWaterMark; }
+
+	/// <summary>
+	/// Returns how many times a frame buffer was grown because a frame overflowed it.
+	/// </summary>
+	/// <returns>The number of times</returns>
+	inline unsigned int growCount() const { return _growCount; }
+
+private:
+	struct Buffer
+	{
+		std::unique_ptr<std::byte[]> memory;
+		std::size_t capacity = 0u;
+		std::atomic<std::size_t> offset = 0u;
+
+		// Heap blocks used once the buffer is full, released when the buffer is reset
+		std::vector<std::unique_ptr<std::byte[]>> overflow;
+		std::size_t overflowBytes = 0u;
+	};
+
+	Buffer _buffers[2];
+	unsigned int _current = 0u;
+	std::size_t _highWaterMark = 0u;
+	unsigned int _growCount = 0u;
+	std::mutex _overflowMutex;
+
+	void* allocateOverflow(Buffer& buffer, std::size_t size, std::size_t alignment);
+};
+
+/// <summary>
+/// STL allocator that takes its memory from a FrameArena. Deallocation is a no-op,
+/// everything is released at once when the arena moves past the frame.
+/// </summary>
+template<typename T>
+class FrameAllocator
+{
+public:
+	using value_type = T;
+
+	FrameAllocator(FrameArena& arena) noexcept
+		: _arena(&arena)
+	{ }
+
+	template<typename U>
+	FrameAllocator(const FrameAllocator<U>& other) noexcept
+		: _arena(other.arena())
+	{ }
+
+	T* allocate(std::size_t count)
+	{
+		return _arena->allocateArray<T>(count);
+	}
+
+	void deallocate(T*, std::size_t) noexcept
+	{ }
+
+	inline FrameArena* arena() const { return _arena; }
+
+	template<typename U>
+	bool operator==(const FrameAllocator<U>& other) const { return _arena == other.arena(); }
+
+	template<typename U>
+	bool operator!=(const FrameAllocator<U>& other) const { return _arena != other.arena(); }
+
+private:
+	FrameArena* _arena;
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameAllocator<char>>;
@@ -0,0 +1,552 @@
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(WRAITH2D_TRACK_ALLOCATIONS) && defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <DbgHelp.h>
+#pragma comment(lib, "dbghelp.lib")
+#elif defined(WRAITH2D_TRACK_ALLOCATIONS) && (defined(__GLIBC__) || defined(__APPLE__))
+#define WRAITH2D_HAS_BACKTRACE
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+constexpr std::size_t MAX_TAGS = 64u;
+constexpr std::size_t MAX_TAG_DEPTH = 32u;
+
+// Must be a power of two
+constexpr std::size_t MAX_CALL_SITES = 4096u;
+constexpr std::size_t MAX_CALL_SITE_PROBES = 64u;
+
+// Return addresses kept per call site, enough to get past the allocator and container frames
+constexpr int MAX_CALL_SITE_FRAMES = 16;
+
+constexpr const char* UNTAGGED = "Untagged";
+
+/**
+* Everything below is constant-initialized and never allocates, since it is used from inside operator new.
+*/
+namespace
+{
+	struct AtomicCounters
+	{
+		std::atomic<uint64_t> allocations{ 0u };
+		std::atomic<uint64_t> bytes{ 0u };
+		std::atomic<uint64_t> frees{ 0u };
+
+		AllocationTracker::Counters exchange()
+		{
+			AllocationTracker::Counters counters;
+			counters.allocations = allocations.exchange(0u, std::memory_order_relaxed);
+			counters.bytes = bytes.exchange(0u, std::memory_order_relaxed);
+			counters.frees = frees.exchange(0u, std::memory_order_relaxed);
+			return counters;
+		}
+
+		AllocationTracker::Counters load() const
+		{
+			AllocationTracker::Counters counters;
+			counters.allocations = allocations.load(std::memory_order_relaxed);
+			counters.bytes = bytes.load(std::memory_order_relaxed);
+			counters.frees = frees.load(std::memory_order_relaxed);
+			return counters;
+		}
+	};
+
+	struct TagEntry
+	{
+		std::atomic<const char*> name{ nullptr };
+		AtomicCounters current;
+		AllocationTracker::Counters last;
+	};
+
+	// A call stack that allocated, keyed by the hash of its return addresses
+	struct CallSiteEntry
+	{
+		std::atomic<uint64_t> key{ 0u };
+		std::atomic<const char*> tag{ nullptr };
+		std::atomic<uint64_t> allocations{ 0u };
+		std::atomic<uint64_t> bytes{ 0u };
+		std::atomic<void*> frames[MAX_CALL_SITE_FRAMES];
+		std::atomic<int> frameCount{ 0 };
+	};
+
+	AtomicCounters s_frame;
+	AtomicCounters s_total;
+	AllocationTracker::Counters s_lastFrame;
+
+	TagEntry s_tags[MAX_TAGS];
+	CallSiteEntry s_callSites[MAX_CALL_SITES];
+	std::atomic<uint64_t> s_droppedCallSites{ 0u };
+
+	thread_local const char* t_tags[MAX_TAG_DEPTH];
+	thread_local std::size_t t_tagDepth = 0u;
+
+	TagEntry* findTag(const char* name, bool create)
+	{
+		for (auto& entry : s_tags)
+		{
+			const char* entryName = entry.name.load(std::memory_order_acquire);
+
+			if (entryName == name)
+			{
+				return &entry;
+			}
+
+			if (entryName == nullptr)
+			{
+				if (!create)
+				{
+					return nullptr;
+				}
+
+				// Claim the free slot, or use it if another thread just claimed it for the same tag
+				if (entry.name.compare_exchange_strong(entryName, name, std::memory_order_acq_rel) || entryName == name)
+				{
+					return &entry;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	void recordCallSite(void* const* frames, int frameCount, const char* tag, std::size_t size)
+	{
+		// FNV-1a over the return addresses, never 0 since that marks a free entry
+		uint64_t key = 0xCBF29CE484222325ull;
+		for (int i = 0; i < frameCount; i++)
+		{
+			key = (key ^ reinterpret_cast<uintptr_t>(frames[i])) * 0x100000001B3ull;
+		}
+		key |= 1u;
+
+		std::size_t hash = static_cast<std::size_t>((key >> 4) * 0x9E3779B97F4A7C15ull);
+
+		for (std::size_t probe = 0; probe < MAX_CALL_SITE_PROBES; probe++)
+		{
+			CallSiteEntry& entry = s_callSites[(hash + probe) & (MAX_CALL_SITES - 1u)];
+			uint64_t entryKey = entry.key.load(std::memory_order_acquire);
+
+			if (entryKey == 0u)
+			{
+				if (entry.key.compare_exchange_strong(entryKey, key, std::memory_order_acq_rel))
+				{
+					entry.tag.store(tag, std::memory_order_relaxed);
+					for (int i = 0; i < frameCount; i++)
+					{
+						entry.frames[i].store(frames[i], std::memory_order_relaxed);
+					}
+					entry.frameCount.store(frameCount, std::memory_order_release);
+					entryKey = key;
+				}
+			}
+
+			if (entryKey == key)
+			{
+				entry.allocations.fetch_add(1u, std::memory_order_relaxed);
+				entry.bytes.fetch_add(size, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		s_droppedCallSites.fetch_add(1u, std::memory_order_relaxed);
+	}
+}
+
+/**
+* Call stacks are only symbolized for reports, where allocating is fine.
+*/
+namespace
+{
+	// Allocator and container internals, which every allocation goes through before reaching the code that asked for it
+	bool isAllocatorFrame(const std::string& symbol)
+	{
+		static const char* const prefixes[] = { "operator new", "std::", "__gnu_cxx::", "__cxx", "void* std::", "AllocationTracker::" };
+		for (const char* prefix : prefixes)
+		{
+			if (symbol.compare(0, std::strlen(prefix), prefix) == 0)
+			{
+				return true;
+			}
+		}
+
+		// Only the function name, parameters like std::vector<int, std::allocator<int>>& don't make a caller part of the allocator
+		return symbol.substr(0, symbol.find('(')).find("allocator") != std::string::npos;
+	}
+
+#if defined(WRAITH2D_TRACK_ALLOCATIONS) && defined(_WIN32)
+	bool s_symbolsInitialized = false;
+#endif
+
+	/// <summary>
+	/// Returns the name of the function a return address is in, empty if it has no symbol.
+	/// </summary>
+	std::string symbolName(void* address)
+	{
+#if defined(WRAITH2D_TRACK_ALLOCATIONS) && defined(_WIN32)
+		if (s_symbolsInitialized)
+		{
+			alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+			SYMBOL_INFO* symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+			symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+			symbol->MaxNameLen = MAX_SYM_NAME;
+
+			if (SymFromAddr(GetCurrentProcess(), reinterpret_cast<DWORD64>(address), nullptr, symbol))
+			{
+				return symbol->Name;
+			}
+		}
+#elif defined(WRAITH2D_HAS_BACKTRACE)
+		// Only exported symbols are found, link with -rdynamic to resolve the engine's own functions
+		Dl_info info;
+		if (dladdr(address, &info) != 0 && info.dli_sname != nullptr)
+		{
+			int status = 0;
+			char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+			std::string name = status == 0 && demangled != nullptr ? demangled : info.dli_sname;
+			std::free(demangled);
+			return name;
+		}
+#else
+		(void)address;
+#endif
+
+		return std::string();
+	}
+
+	/// <summary>
+	/// Returns the first return address of a call stack outside the allocator and the standard library,
+	/// the innermost one if every frame is in there or none can be symbolized.
+	/// </summary>
+	void* callerFrame(const CallSiteEntry& entry)
+	{
+		int frameCount = entry.frameCount.load(std::memory_order_acquire);
+		for (int i = 0; i < frameCount; i++)
+		{
+			void* frame = entry.frames[i].load(std::memory_order_relaxed);
+			std::string symbol = symbolName(frame);
+			if (!symbol.empty() && !isAllocatorFrame(symbol))
+			{
+				return frame;
+			}
+		}
+
+		return frameCount > 0 ? entry.frames[0].load(std::memory_order_relaxed) : nullptr;
+	}
+}
+
+void AllocationTracker::beginFrame()
+{
+	s_lastFrame = s_frame.exchange();
+
+	for (auto& entry : s_tags)
+	{
+		if (entry.name.load(std::memory_order_acquire) == nullptr)
+		{
+			break;
+		}
+
+		entry.last = entry.current.exchange();
+	}
+}
+
+AllocationTracker::Counters AllocationTracker::lastFrame()
+{
+	return s_lastFrame;
+}
+
+AllocationTracker::Counters AllocationTracker::total()
+{
+	return s_total.load();
+}
+
+AllocationTracker::Counters AllocationTracker::lastFrame(const char* tag)
+{
+	TagEntry* entry = findTag(tag, false);
+	return entry != nullptr ? entry->last : Counters();
+}
+
+void AllocationTracker::report(std::ostream& stream, std::size_t topCallSites)
+{
+	if (!isEnabled())
+	{
+		stream << "Allocation tracking is disabled, define WRAITH2D_TRACK_ALLOCATIONS to enable it" << std::endl;
+		return;
+	}
+
+	stream << "Last frame: " << s_lastFrame.allocations << " allocations, " << s_lastFrame.bytes << " bytes, " << s_lastFrame.frees << " frees" << std::endl;
+
+	for (auto& entry : s_tags)
+	{
+		const char* name = entry.name.load(std::memory_order_acquire);
+		if (name == nullptr)
+		{
+			break;
+		}
+
+		stream << "  " << name << ": " << entry.last.allocations << " allocations, " << entry.last.bytes << " bytes" << std::endl;
+	}
+
+#if defined(WRAITH2D_TRACK_ALLOCATIONS) && defined(_WIN32)
+	HANDLE process = GetCurrentProcess();
+	static bool s_symbolsReady = SymInitialize(process, nullptr, TRUE) == TRUE;
+	s_symbolsInitialized = s_symbolsReady;
+#endif
+
+	// Snapshot the call sites before sorting, the vector itself allocates
+	struct CallSite
+	{
+		void* address;
+		const char* tag;
+		uint64_t allocations;
+		uint64_t bytes;
+	};
+
+	// Call stacks are grouped by their tag and the first frame outside the allocator,
+	// so a function allocating from several paths inside a container shows up once
+	std::vector<CallSite> callSites;
+	for (auto& entry : s_callSites)
+	{
+		if (entry.key.load(std::memory_order_acquire) != 0u)
+		{
+			callSites.push_back({ callerFrame(entry), entry.tag.load(std::memory_order_relaxed), entry.allocations.load(std::memory_order_relaxed), entry.bytes.load(std::memory_order_relaxed) });
+		}
+	}
+
+	std::sort(callSites.begin(), callSites.end(), [](const CallSite& a, const CallSite& b)
+		{
+			return a.address != b.address ? std::less<void*>()(a.address, b.address) : std::less<const char*>()(a.tag, b.tag);
+		});
+
+	std::size_t merged = 0u;
+	for (std::size_t i = 0; i < callSites.size(); i++)
+	{
+		if (merged > 0u && callSites[merged - 1u].address == callSites[i].address && callSites[merged - 1u].tag == callSites[i].tag)
+		{
+			callSites[merged - 1u].allocations += callSites[i].allocations;
+			callSites[merged - 1u].bytes += callSites[i].bytes;
+		}
+		else
+		{
+			callSites[merged++] = callSites[i];
+		}
+	}
+	callSites.resize(merged);
+
+	std::sort(callSites.begin(), callSites.end(), [](const CallSite& a, const CallSite& b) { return a.allocations > b.allocations; });
+
+	stream << "Top call sites:" << std::endl;
+	for (std::size_t i = 0; i < std::min(topCallSites, callSites.size()); i++)
+	{
+		const CallSite& callSite = callSites[i];
+		stream << "  " << callSite.allocations << " allocations, " << callSite.bytes << " bytes [" << callSite.tag << "] " << callSite.address;
+
+		std::string symbol = symbolName(callSite.address);
+		if (!symbol.empty())
+		{
+			stream << " " << symbol;
+		}
+
+#if defined(WRAITH2D_TRACK_ALLOCATIONS) && defined(_WIN32)
+		if (s_symbolsInitialized)
+		{
+			DWORD64 address = reinterpret_cast<DWORD64>(callSite.address);
+			IMAGEHLP_LINE64 line;
+			DWORD displacement = 0;
+			line.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+			if (SymGetLineFromAddr64(process, address, &displacement, &line))
+			{
+				stream << " (" << line.FileName << ":" << line.LineNumber << ")";
+			}
+		}
+#endif
+
+		stream << std::endl;
+	}
+
+	if (s_droppedCallSites.load(std::memory_order_relaxed) > 0u)
+	{
+		stream << "  " << s_droppedCallSites.load(std::memory_order_relaxed) << " allocations didn't fit in the call site table" << std::endl;
+	}
+}
+
+void AllocationTracker::resetCallSites()
+{
+	for (auto& entry : s_callSites)
+	{
+		entry.allocations.store(0u, std::memory_order_relaxed);
+		entry.bytes.store(0u, std::memory_order_relaxed);
+		entry.tag.store(nullptr, std::memory_order_relaxed);
+		entry.frameCount.store(0, std::memory_order_relaxed);
+		entry.key.store(0u, std::memory_order_release);
+	}
+
+	s_droppedCallSites.store(0u, std::memory_order_relaxed);
+}
+
+void AllocationTracker::onAllocation(std::size_t size, void* const* callStack, int frameCount)
+{
+	s_frame.allocations.fetch_add(1u, std::memory_order_relaxed);
+	s_frame.bytes.fetch_add(size, std::memory_order_relaxed);
+	s_total.allocations.fetch_add(1u, std::memory_order_relaxed);
+	s_total.bytes.fetch_add(size, std::memory_order_relaxed);
+
+	const char* tag = t_tagDepth > 0u ? t_tags[t_tagDepth - 1u] : UNTAGGED;
+
+	TagEntry* entry = findTag(tag, true);
+	if (entry != nullptr)
+	{
+		entry->current.allocations.fetch_add(1u, std::memory_order_relaxed);
+		entry->current.bytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	recordCallSite(callStack, frameCount, tag, size);
+}
+
+void AllocationTracker::onFree()
+{
+	s_frame.frees.fetch_add(1u, std::memory_order_relaxed);
+	s_total.frees.fetch_add(1u, std::memory_order_relaxed);
+}
+
+void AllocationTracker::pushTag(const char* tag)
+{
+	if (t_tagDepth < MAX_TAG_DEPTH)
+	{
+		t_tags[t_tagDepth] = tag;
+	}
+
+	// Keep counting past the limit so pushes and pops stay balanced
+	++t_tagDepth;
+}
+
+void AllocationTracker::popTag()
+{
+	if (t_tagDepth > 0u)
+	{
+		--t_tagDepth;
+	}
+}
+
+/**
+* /////////////////////////////////////////////////////////////////
+* ******************* Global operator new/delete ******************
+* /////////////////////////////////////////////////////////////////
+*/
+
+#ifdef WRAITH2D_TRACK_ALLOCATIONS
+
+// Captures the return addresses above the operator new it is used in, skipping that frame.
+// backtrace only calls malloc, never operator new, so it doesn't recurse into the tracker
+#if defined(_WIN32)
+#define ALLOCATION_CALL_STACK(frames, frameCount) \
+	void* frames[MAX_CALL_SITE_FRAMES]; \
+	int frameCount = static_cast<int>(CaptureStackBackTrace(1, MAX_CALL_SITE_FRAMES, frames, nullptr))
+#elif defined(WRAITH2D_HAS_BACKTRACE)
+#define ALLOCATION_CALL_STACK(frames, frameCount) \
+	void* frames##Stack[MAX_CALL_SITE_FRAMES + 1]; \
+	int frameCount = std::max(backtrace(frames##Stack, MAX_CALL_SITE_FRAMES + 1) - 1, 0); \
+	void* const* frames = frames##Stack + 1
+#else
+#define ALLOCATION_CALL_STACK(frames, frameCount) \
+	void* frames[1] = { __builtin_return_address(0) }; \
+	int frameCount = 1
+#endif
+
+void* operator new(std::size_t size)
+{
+	void* ptr = std::malloc(size > 0u ? size : 1u);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	ALLOCATION_CALL_STACK(callStack, frameCount);
+	AllocationTracker::onAllocation(size, callStack, frameCount);
+	return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+	void* ptr = std::malloc(size > 0u ? size : 1u);
+	if (ptr == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	ALLOCATION_CALL_STACK(callStack, frameCount);
+	AllocationTracker::onAllocation(size, callStack, frameCount);
+	return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	void* ptr = std::malloc(size > 0u ? size : 1u);
+	if (ptr != nullptr)
+	{
+		ALLOCATION_CALL_STACK(callStack, frameCount);
+		AllocationTracker::onAllocation(size, callStack, frameCount);
+	}
+
+	return ptr;
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	void* ptr = std::malloc(size > 0u ? size : 1u);
+	if (ptr != nullptr)
+	{
+		ALLOCATION_CALL_STACK(callStack, frameCount);
+		AllocationTracker::onAllocation(size, callStack, frameCount);
+	}
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (ptr != nullptr)
+	{
+		AllocationTracker::onFree();
+		std::free(ptr);
+	}
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	operator delete(ptr);
+}
+
+#endif
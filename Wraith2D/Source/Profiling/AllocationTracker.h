@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+* Allocations are only tracked when WRAITH2D_TRACK_ALLOCATIONS is defined, which replaces the
+* global operator new/delete. Otherwise ALLOCATION_TAG compiles to nothing and every counter stays at 0.
+*/
+#ifdef WRAITH2D_TRACK_ALLOCATIONS
+#define ALLOCATION_TAG_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_TAG_CONCAT(a, b) ALLOCATION_TAG_CONCAT_INNER(a, b)
+#define ALLOCATION_TAG(name) AllocationTag ALLOCATION_TAG_CONCAT(allocationTag, __LINE__)(name)
+#else
+#define ALLOCATION_TAG(name)
+#endif
+
+class AllocationTracker
+{
+public:
+	struct Counters
+	{
+		uint64_t allocations = 0u;
+		uint64_t bytes = 0u;
+		uint64_t frees = 0u;
+	};
+
+	/// <summary>
+	/// Checks whether allocation tracking was compiled in.
+	/// </summary>
+	/// <returns>True if it was, false if not</returns>
+	static constexpr bool isEnabled()
+	{
+#ifdef WRAITH2D_TRACK_ALLOCATIONS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/// <summary>
+	/// Closes the current frame, making its counters available through lastFrame(), and starts a new one.
+	/// </summary>
+	static void beginFrame();
+
+	/// <summary>
+	/// Returns the counters of the last complete frame.
+	/// </summary>
+	/// <returns>The frame counters</returns>
+	static Counters lastFrame();
+
+	/// <summary>
+	/// Returns the counters accumulated since the program started.
+	/// </summary>
+	/// <returns>The total counters</returns>
+	static Counters total();
+
+	/// <summary>
+	/// Returns the counters of a tag in the last complete frame.
+	/// </summary>
+	/// <param name="tag">The tag name</param>
+	/// <returns>The tag counters, empty if the tag was never used</returns>
+	static Counters lastFrame(const char* tag);
+
+	/// <summary>
+	/// Writes the per-tag counters of the last frame and the call sites with the most allocations.
+	/// A call site is the first function of the call stack outside the allocator and the standard library.
+	/// </summary>
+	/// <param name="stream">The output stream</param>
+	/// <param name="topCallSites">The number of call sites to list</param>
+	static void report(std::ostream& stream, std::size_t topCallSites = 20u);
+
+	/// <summary>
+	/// Clears the call site table, so a report only covers what happens after this call.
+	/// </summary>
+	static void resetCallSites();
+
+	/// <summary>
+	/// Records an allocation. Called by the replaced operator new.
+	/// </summary>
+	/// <param name="size">The allocation size</param>
+	/// <param name="callStack">The return addresses above operator new, innermost first</param>
+	/// <param name="frameCount">The number of return addresses</param>
+	static void onAllocation(std::size_t size, void* const* callStack, int frameCount);
+
+	/// <summary>
+	/// Records a deallocation. Called by the replaced operator delete.
+	/// </summary>
+	static void onFree();
+
+	/// <summary>
+	/// Pushes a tag that allocations on the calling thread are attributed to.
+	/// </summary>
+	/// <param name="tag">The tag name. Must be a string with static storage</param>
+	static void pushTag(const char* tag);
+
+	/// <summary>
+	/// Pops the most recent tag of the calling thread.
+	/// </summary>
+	static void popTag();
+};
+
+class AllocationTag
+{
+public:
+	AllocationTag(const char* tag) { AllocationTracker::pushTag(tag); }
+	~AllocationTag() { AllocationTracker::popTag(); }
+
+	AllocationTag(const AllocationTag&) = delete;
+	AllocationTag& operator=(const AllocationTag&) = delete;
+};
@@ -0,0 +1,209 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+FrameStats::FrameStats(std::size_t capacity)
+	: _capacity(capacity > 0u ? capacity : 1u)
+{
+	_msPerCount = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+	_frames.resize(_capacity, 0.f);
+	_scratch.reserve(_capacity);
+	_channels.reserve(16);
+}
+
+void FrameStats::beginFrame()
+{
+	Uint64 now = SDL_GetPerformanceCounter();
+
+	if (_frameStart != 0u)
+	{
+		_frames[_head] = static_cast<float>((now - _frameStart) * _msPerCount);
+
+		for (auto& channel : _channels)
+		{
+			channel.samples[_head] = static_cast<float>(channel.current * _msPerCount);
+			channel.current = 0u;
+		}
+
+		_head = (_head + 1u) % _capacity;
+		_count = std::min(_count + 1u, _capacity);
+	}
+
+	_frameStart = now;
+}
+
+void FrameStats::record(const char* channel, Uint64 counterDelta)
+{
+	Channel* existing = findChannel(channel);
+
+	if (existing == nullptr)
+	{
+		Channel newChannel;
+		newChannel.name = channel;
+		newChannel.samples.resize(_capacity, 0.f);
+		_channels.emplace_back(std::move(newChannel));
+		existing = &_channels.back();
+	}
+
+	existing->current += counterDelta;
+}
+
+FrameStats::Summary FrameStats::frameSummary() const
+{
+	return summarize(_frames, true);
+}
+
+FrameStats::Summary FrameStats::channelSummary(const char* channel) const
+{
+	const Channel* existing = findChannel(channel);
+	return existing != nullptr ? summarize(existing->samples, false) : Summary();
+}
+
+std::vector<const char*> FrameStats::channels() const
+{
+	std::vector<const char*> names;
+	names.reserve(_channels.size());
+
+	for (auto& channel : _channels)
+	{
+		names.emplace_back(channel.name);
+	}
+
+	return names;
+}
+
+bool FrameStats::dumpCSV(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cerr << "Failed to write frame stats [" << path << "]!" << std::endl;
+		return false;
+	}
+
+	file << "frame,frame_ms";
+	for (auto& channel : _channels)
+	{
+		file << "," << channel.name << "_ms";
+	}
+	file << "\n";
+
+	// Oldest frame first
+	std::size_t first = _count < _capacity ? 0u : _head;
+	for (std::size_t i = 0; i < _count; i++)
+	{
+		std::size_t index = (first + i) % _capacity;
+		file << i << "," << _frames[index];
+
+		for (auto& channel : _channels)
+		{
+			file << "," << channel.samples[index];
+		}
+
+		file << "\n";
+	}
+
+	std::cout << "Frame stats: [" << path << "] written!" << std::endl;
+	return true;
+}
+
+std::string FrameStats::report() const
+{
+	char line[160];
+	std::string result;
+
+	Summary frames = frameSummary();
+	SDL_snprintf(line, sizeof(line), "Frame  avg %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms  hitches %u\n",
+		frames.average, frames.p50, frames.p95, frames.p99, frames.max, frames.hitches);
+	result += line;
+
+	for (auto& channel : _channels)
+	{
+		Summary summary = summarize(channel.samples, false);
+		SDL_snprintf(line, sizeof(line), "%s  avg %.2f  p95 %.2f  max %.2f ms\n", channel.name, summary.average, summary.p95, summary.max);
+		result += line;
+	}
+
+	return result;
+}
+
+void FrameStats::reset()
+{
+	_head = 0u;
+	_count = 0u;
+	_frameStart = 0u;
+
+	std::fill(_frames.begin(), _frames.end(), 0.f);
+	for (auto& channel : _channels)
+	{
+		std::fill(channel.samples.begin(), channel.samples.end(), 0.f);
+		channel.current = 0u;
+	}
+}
+
+FrameStats::Channel* FrameStats::findChannel(const char* name)
+{
+	return const_cast<Channel*>(static_cast<const FrameStats*>(this)->findChannel(name));
+}
+
+const FrameStats::Channel* FrameStats::findChannel(const char* name) const
+{
+	// Channel names are usually literals, so compare pointers before falling back to the contents
+	for (auto& channel : _channels)
+	{
+		if (channel.name == name || std::strcmp(channel.name, name) == 0)
+		{
+			return &channel;
+		}
+	}
+
+	return nullptr;
+}
+
+FrameStats::Summary FrameStats::summarize(const std::vector<float>& samples, bool countHitches) const
+{
+	Summary summary;
+	if (_count == 0u)
+	{
+		return summary;
+	}
+
+	// Before the window is full only the first _count entries are valid
+	_scratch.assign(samples.begin(), samples.begin() + _count);
+	std::sort(_scratch.begin(), _scratch.end());
+
+	double total = 0.0;
+	for (float sample : _scratch)
+	{
+		total += sample;
+	}
+
+	auto percentile = [this](double p)
+	{
+		std::size_t index = static_cast<std::size_t>(p * (_scratch.size() - 1u) + 0.5);
+		return static_cast<double>(_scratch[index]);
+	};
+
+	summary.samples = static_cast<unsigned int>(_count);
+	summary.average = total / _count;
+	summary.p50 = percentile(0.50);
+	summary.p95 = percentile(0.95);
+	summary.p99 = percentile(0.99);
+	summary.max = _scratch.back();
+
+	if (countHitches)
+	{
+		double limit = summary.p50 * _hitchFactor;
+		if (_hitchThreshold > 0.0)
+		{
+			limit = std::min(limit, _hitchThreshold);
+		}
+
+		summary.hitches = static_cast<unsigned int>(_scratch.end() - std::upper_bound(_scratch.begin(), _scratch.end(), static_cast<float>(limit)));
+	}
+
+	return summary;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+class FrameStats
+{
+public:
+	struct Summary
+	{
+		double average = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		unsigned int hitches = 0u;
+		unsigned int samples = 0u;
+	};
+
+	/// <summary>
+	/// Times a scope and adds the duration to a channel of the current frame.
+	/// </summary>
+	class ScopedTimer
+	{
+	public:
+		ScopedTimer(FrameStats& stats, const char* channel)
+			: _stats(stats)
+			, _channel(channel)
+			, _start(SDL_GetPerformanceCounter())
+		{ }
+
+		~ScopedTimer()
+		{
+			_stats.record(_channel, SDL_GetPerformanceCounter() - _start);
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		FrameStats& _stats;
+		const char* _channel;
+		Uint64 _start;
+	};
+
+	/// <summary>
+	/// Creates the statistics service.
+	/// </summary>
+	/// <param name="capacity">The number of frames kept in the rolling window</param>
+	FrameStats(std::size_t capacity = 600u);
+
+	/// <summary>
+	/// Closes the current frame, storing its duration and channel times, and starts a new one.
+	/// Should be called once per frame, at the same point of the loop.
+	/// </summary>
+	void beginFrame();
+
+	/// <summary>
+	/// Adds time to a channel of the current frame. Channels are created on first use.
+	/// </summary>
+	/// <param name="channel">The channel name. Must outlive the service</param>
+	/// <param name="counterDelta">The time spent, in high-resolution counter units</param>
+	void record(const char* channel, Uint64 counterDelta);
+
+	/// <summary>
+	/// Returns the statistics of the frame times in the rolling window, in milliseconds.
+	/// </summary>
+	/// <returns>The frame time summary</returns>
+	Summary frameSummary() const;
+
+	/// <summary>
+	/// Returns the statistics of a channel in the rolling window, in milliseconds.
+	/// </summary>
+	/// <param name="channel">The channel name</param>
+	/// <returns>The channel summary, empty if the channel doesn't exist</returns>
+	Summary channelSummary(const char* channel) const;
+
+	/// <summary>
+	/// Returns the names of all channels recorded so far.
+	/// </summary>
+	/// <returns>A vector with the channel names</returns>
+	std::vector<const char*> channels() const;
+
+	/// <summary>
+	/// Sets how many times slower than the median a frame must be to count as a hitch.
+	/// </summary>
+	/// <param name="factor">The hitch factor</param>
+	inline void setHitchFactor(double factor) { _hitchFactor = factor; }
+
+	/// <summary>
+	/// Sets an absolute frame time above which a frame always counts as a hitch.
+	/// </summary>
+	/// <param name="milliseconds">The threshold, or 0 to only use the hitch factor</param>
+	inline void setHitchThreshold(double milliseconds) { _hitchThreshold = milliseconds; }
+
+	/// <summary>
+	/// Writes every frame in the rolling window as a CSV row, with one column per channel.
+	/// </summary>
+	/// <param name="path">The path of the CSV file</param>
+	/// <returns>True if the file was written, false if not</returns>
+	bool dumpCSV(const std::string& path) const;
+
+	/// <summary>
+	/// Builds a short multi-line report, used by the on-screen overlay.
+	/// </summary>
+	/// <returns>The report</returns>
+	std::string report() const;
+
+	/// <summary>
+	/// Clears all recorded frames.
+	/// </summary>
+	void reset();
+
+private:
+	struct Channel
+	{
+		const char* name = nullptr;
+		std::vector<float> samples;
+		Uint64 current = 0u;
+	};
+
+	std::size_t _capacity;
+	std::size_t _head = 0u;
+	std::size_t _count = 0u;
+	double _msPerCount = 0.0;
+	Uint64 _frameStart = 0u;
+
+	double _hitchFactor = 2.0;
+	double _hitchThreshold = 0.0;
+
+	std::vector<float> _frames;
+	std::vector<Channel> _channels;
+
+	// Reused when sorting samples for percentiles
+	mutable std::vector<float> _scratch;
+
+	Channel* findChannel(const char* name);
+	const Channel* findChannel(const char* name) const;
+	Summary summarize(const std::vector<float>& samples, bool countHitches) const;
+};
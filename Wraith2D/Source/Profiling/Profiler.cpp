@@ -0,0 +1,147 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// Events each thread can record per session before new ones are dropped
+constexpr uint32_t THREAD_BUFFER_CAPACITY = 1u << 17;
+
+std::atomic<bool> Profiler::s_recording = false;
+std::atomic<uint64_t> Profiler::s_droppedEvents = 0u;
+uint64_t Profiler::s_sessionStart = 0u;
+
+std::mutex Profiler::s_buffersMutex;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::s_buffers;
+
+void Profiler::beginSession()
+{
+	std::lock_guard<std::mutex> lock(s_buffersMutex);
+
+	for (auto& buffer : s_buffers)
+	{
+		buffer->count.store(0u, std::memory_order_relaxed);
+	}
+
+	s_droppedEvents.store(0u, std::memory_order_relaxed);
+	s_sessionStart = now();
+	s_recording.store(true, std::memory_order_release);
+}
+
+bool Profiler::endSession(const std::string& path)
+{
+	s_recording.store(false, std::memory_order_release);
+
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cerr << "Failed to write profiler trace [" << path << "]!" << std::endl;
+		return false;
+	}
+
+	auto writeEscaped = [&file](const char* text)
+	{
+		for (const char* c = text; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				file << '\\';
+			}
+
+			file << *c;
+		}
+	};
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+	bool first = true;
+	std::lock_guard<std::mutex> lock(s_buffersMutex);
+
+	for (auto& buffer : s_buffers)
+	{
+		if (buffer->name != nullptr)
+		{
+			file << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadID << ",\"args\":{\"name\":\"";
+			writeEscaped(buffer->name);
+			file << "\"}}";
+			first = false;
+		}
+
+		uint32_t count = buffer->count.load(std::memory_order_acquire);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const Event& event = buffer->events[i];
+
+			// Chrome trace timestamps are in microseconds, fractions keep the nanosecond precision
+			file << (first ? "" : ",") << "{\"name\":\"";
+			writeEscaped(event.name);
+			file << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadID
+				<< ",\"ts\":" << (event.start - s_sessionStart) / 1000.0
+				<< ",\"dur\":" << event.duration / 1000.0
+				<< "}";
+			first = false;
+		}
+
+		buffer->count.store(0u, std::memory_order_relaxed);
+	}
+
+	file << "]}" << std::endl;
+
+	std::cout << "Profiler trace: [" << path << "] written!" << std::endl;
+
+	if (s_droppedEvents.load(std::memory_order_relaxed) > 0u)
+	{
+		std::cerr << "Profiler dropped " << s_droppedEvents.load(std::memory_order_relaxed) << " events, thread buffers were full" << std::endl;
+	}
+
+	return true;
+}
+
+void Profiler::setThreadName(const char* name)
+{
+	threadBuffer().name = name;
+}
+
+uint64_t Profiler::now()
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end)
+{
+	ThreadBuffer& buffer = threadBuffer();
+
+	uint32_t index = buffer.count.load(std::memory_order_relaxed);
+	if (index >= THREAD_BUFFER_CAPACITY)
+	{
+		s_droppedEvents.fetch_add(1u, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer.events[index] = { name, start, end - start };
+
+	// Publish the event so the exporting thread sees it fully written
+	buffer.count.store(index + 1u, std::memory_order_release);
+}
+
+Profiler::ThreadBuffer& Profiler::threadBuffer()
+{
+	thread_local ThreadBuffer* t_buffer = nullptr;
+
+	if (t_buffer == nullptr)
+	{
+		std::unique_ptr<ThreadBuffer> buffer = std::make_unique<ThreadBuffer>();
+		buffer->events = std::make_unique<Event[]>(THREAD_BUFFER_CAPACITY);
+
+		std::lock_guard<std::mutex> lock(s_buffersMutex);
+		buffer->threadID = static_cast<uint32_t>(s_buffers.size());
+		t_buffer = buffer.get();
+
+		// Buffers are owned by the profiler so events survive their thread
+		s_buffers.emplace_back(std::move(buffer));
+	}
+
+	return *t_buffer;
+}
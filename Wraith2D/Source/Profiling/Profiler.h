@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+* Zones are only recorded when WRAITH2D_PROFILE is defined. Otherwise the macros below
+* compile to nothing and the Profiler just writes empty traces.
+*/
+#ifdef WRAITH2D_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_THREAD(name) Profiler::setThreadName(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_THREAD(name)
+#endif
+
+class Profiler
+{
+public:
+	struct Event
+	{
+		const char* name;
+		uint64_t start;
+		uint64_t duration;
+	};
+
+	/// <summary>
+	/// Starts recording zones. Any events from a previous session are discarded.
+	/// </summary>
+	static void beginSession();
+
+	/// <summary>
+	/// Stops recording and writes every recorded zone to a Chrome trace / Perfetto JSON file.
+	/// Should be called while no other thread is inside a zone.
+	/// </summary>
+	/// <param name="path">The path of the JSON file</param>
+	/// <returns>True if the file was written, false if not</returns>
+	static bool endSession(const std::string& path);
+
+	/// <summary>
+	/// Checks whether a session is being recorded.
+	/// </summary>
+	/// <returns>True if it is, false if not</returns>
+	inline static bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// Sets the name shown for the calling thread in the trace.
+	/// </summary>
+	/// <param name="name">The thread name. Must outlive the session</param>
+	static void setThreadName(const char* name);
+
+	/// <summary>
+	/// Returns the number of events dropped because a thread buffer was full.
+	/// </summary>
+	/// <returns>The number of dropped events</returns>
+	inline static uint64_t droppedEvents() { return s_droppedEvents.load(std::memory_order_relaxed); }
+
+	/// <summary>
+	/// Returns a monotonic timestamp in nanoseconds.
+	/// </summary>
+	/// <returns>The timestamp</returns>
+	static uint64_t now();
+
+	/// <summary>
+	/// Records a finished zone in the calling thread's buffer.
+	/// Only the owning thread writes to a buffer, so recording never takes a lock.
+	/// </summary>
+	/// <param name="name">The zone name. Must outlive the session</param>
+	/// <param name="start">The zone start timestamp</param>
+	/// <param name="end">The zone end timestamp</param>
+	static void record(const char* name, uint64_t start, uint64_t end);
+
+private:
+	struct ThreadBuffer
+	{
+		uint32_t threadID = 0u;
+		const char* name = nullptr;
+		std::unique_ptr<Event[]> events;
+		std::atomic<uint32_t> count = 0u;
+	};
+
+	static std::atomic<bool> s_recording;
+	static std::atomic<uint64_t> s_droppedEvents;
+	static uint64_t s_sessionStart;
+
+	// Guards registration of new thread buffers only, never the recording path
+	static std::mutex s_buffersMutex;
+	static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+
+	static ThreadBuffer& threadBuffer();
+};
+
+class ProfileZone
+{
+public:
+	ProfileZone(const char* name)
+		: _name(name)
+		, _start(Profiler::isRecording() ? Profiler::now() : 0u)
+	{ }
+
+	~ProfileZone()
+	{
+		if (_start != 0u && Profiler::isRecording())
+		{
+			Profiler::record(_name, _start, Profiler::now());
+		}
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	const char* _name;
+	uint64_t _start;
+};
@@ -0,0 +1,189 @@
+#include "RenderBenchmark.h"
+
+#include <iomanip>
+#include <random>
+#include <vector>
+
+#include "../Engine.h"
+#include "../AssetManager.h"
+#include "../ECS/Components/Sprite.h"
+#include "../ECS/Components/Text.h"
+
+namespace
+{
+	constexpr int TEXTURE_SIZE = 64;
+	constexpr const char* TEXTURE_PREFIX = "RenderBenchmark";
+
+	SDL_Texture* createTexture(std::mt19937& random)
+	{
+		SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, TEXTURE_SIZE, TEXTURE_SIZE, 32, SDL_PIXELFORMAT_ARGB8888);
+		if (surface == nullptr)
+		{
+			return nullptr;
+		}
+
+		// A checkerboard with a transparent border, so blending is exercised like with real sprites
+		Uint32 light = SDL_MapRGBA(surface->format, random() % 256, random() % 256, random() % 256, 255);
+		Uint32 dark = SDL_MapRGBA(surface->format, random() % 128, random() % 128, random() % 128, 255);
+		Uint32 clear = SDL_MapRGBA(surface->format, 0, 0, 0, 0);
+
+		for (int y = 0; y < TEXTURE_SIZE; y++)
+		{
+			Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+			for (int x = 0; x < TEXTURE_SIZE; x++)
+			{
+				bool border = x < 2 || y < 2 || x >= TEXTURE_SIZE - 2 || y >= TEXTURE_SIZE - 2;
+				row[x] = border ? clear : (((x / 8) + (y / 8)) % 2 == 0 ? light : dark);
+			}
+		}
+
+		SDL_Texture* texture = SDL_CreateTextureFromSurface(Engine::instance().getRenderer(), surface);
+		SDL_FreeSurface(surface);
+
+		return texture;
+	}
+}
+
+void RenderBenchmark::createScene(const Settings& settings)
+{
+	std::mt19937 random(settings.seed);
+	Engine& engine = Engine::instance();
+	Vector2 world = engine.getWorldDimensions();
+
+	for (int i = 0; i < settings.textures; i++)
+	{
+		std::string id = TEXTURE_PREFIX + std::to_string(i);
+		if (AssetManager::instance().getTexture(id) == nullptr)
+		{
+			AssetManager::instance().addTexture(id, createTexture(random));
+		}
+	}
+
+	for (int i = 0; i < settings.sprites; i++)
+	{
+		Entity& entity = engine.createEntity();
+		Transform& transform = entity.getComponent<Transform>();
+		transform.position.x = static_cast<float>(random() % SDL_max(static_cast<int>(world.x) - TEXTURE_SIZE, 1));
+		transform.position.y = static_cast<float>(random() % SDL_max(static_cast<int>(world.y) - TEXTURE_SIZE, 1));
+
+		// Some rotated sprites, so both the SDL_RenderCopy and SDL_RenderCopyEx paths are measured
+		if (i % 8 == 0)
+		{
+			transform.rotation = static_cast<float>(random() % 360);
+		}
+
+		RenderLayer layer = static_cast<RenderLayer>(random() % RenderLayer::UI);
+		int depth = static_cast<int>(random() % 100);
+		int size = TEXTURE_SIZE / 2 + static_cast<int>(random() % (TEXTURE_SIZE / 2));
+		std::string textureID = TEXTURE_PREFIX + std::to_string(random() % SDL_max(settings.textures, 1));
+
+		Sprite& sprite = entity.addComponent<Sprite>(layer, depth, textureID, 0, 0, TEXTURE_SIZE, TEXTURE_SIZE, size, size, 0.f, 0.f);
+
+		if (i % 16 == 0)
+		{
+			sprite.setAlpha(160);
+		}
+	}
+
+	if (settings.texts <= 0 || settings.fontID.empty())
+	{
+		return;
+	}
+
+	if (AssetManager::instance().getFont(settings.fontID) == nullptr)
+	{
+		std::cerr << "Render benchmark font [" << settings.fontID << "] isn't loaded, skipping text labels" << std::endl;
+		return;
+	}
+
+	for (int i = 0; i < settings.texts; i++)
+	{
+		Entity& entity = engine.createEntity();
+		Transform& transform = entity.getComponent<Transform>();
+		transform.position.x = static_cast<float>(random() % SDL_max(static_cast<int>(world.x), 1));
+		transform.position.y = static_cast<float>(random() % SDL_max(static_cast<int>(world.y), 1));
+
+		// Few distinct strings, like labels and damage numbers, so the text cache gets hits
+		SDL_Color color{ static_cast<Uint8>(random() % 256), static_cast<Uint8>(random() % 256), static_cast<Uint8>(random() % 256), 255 };
+		Text& text = entity.addComponent<Text>(settings.fontID, i, "Label " + std::to_string(i % 32), color, 0u);
+
+		if (i % 2 == 0)
+		{
+			text.setGlyphRendering(true);
+		}
+	}
+}
+
+RenderBenchmark::Result RenderBenchmark::run(const Settings& settings)
+{
+	Engine& engine = Engine::instance();
+	createScene(settings);
+
+	Vector2 world = engine.getWorldDimensions();
+	SDL_Rect camera = engine.getCamera();
+	int panWidth = SDL_max(static_cast<int>(world.x) - camera.w, 0);
+	int panHeight = SDL_max(static_cast<int>(world.y) - camera.h, 0);
+
+	Result result;
+	Uint64 start = 0u;
+
+	engine.setRenderThreadEnabled(settings.renderThread);
+
+	for (int frame = 0; frame < settings.warmupFrames + settings.frames && engine.isRunning(); frame++)
+	{
+		if (frame == settings.warmupFrames)
+		{
+			engine.frameStats().reset();
+			start = SDL_GetPerformanceCounter();
+		}
+
+		if (settings.panCamera && panWidth > 0)
+		{
+			// Sweep back and forth across the world
+			int sweep = (frame * 16) % (2 * panWidth);
+			engine.setCameraPosition(sweep < panWidth ? sweep : 2 * panWidth - sweep, panHeight / 2);
+		}
+
+		engine.handleEvents();
+		engine.update();
+		engine.render();
+
+		if (frame >= settings.warmupFrames)
+		{
+			const DrawStats& drawStats = engine.drawStats();
+			result.drawCalls += drawStats.drawCalls;
+			result.textureSwitches += drawStats.textureSwitches;
+			result.batches += drawStats.batches;
+			result.frames++;
+		}
+	}
+
+	// Stopping the render thread waits for the last frame, so it is part of the measured time
+	engine.setRenderThreadEnabled(false);
+
+	// beginFrame closes a frame, so close the last measured one
+	engine.frameStats().beginFrame();
+
+	if (result.frames > 0)
+	{
+		result.seconds = Clock::toSeconds(SDL_GetPerformanceCounter() - start);
+		result.framesPerSecond = result.seconds > 0.0 ? result.frames / result.seconds : 0.0;
+		result.frameTimes = engine.frameStats().frameSummary();
+		result.drawCalls /= result.frames;
+		result.textureSwitches /= result.frames;
+		result.batches /= result.frames;
+	}
+
+	return result;
+}
+
+void RenderBenchmark::print(std::ostream& stream, const Result& result)
+{
+	stream << std::fixed << std::setprecision(2);
+	stream << "Frames: " << result.frames << " in " << result.seconds << " s" << std::endl;
+	stream << "FPS: " << result.framesPerSecond << std::endl;
+	stream << "Frame time (ms): avg " << result.frameTimes.average << "  p50 " << result.frameTimes.p50
+		<< "  p95 " << result.frameTimes.p95 << "  p99 " << result.frameTimes.p99 << "  max " << result.frameTimes.max << std::endl;
+	stream << "Draw calls: " << result.drawCalls << "  batches: " << result.batches << "  texture switches: " << result.textureSwitches << std::endl;
+	stream << std::defaultfloat;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "FrameStats.h"
+#include "../Rendering/SpriteBatcher.h"
+
+/// <summary>
+/// Generates a synthetic scene and measures how fast the engine renders it.
+/// Meant to run on a headless engine (Engine::initHeadless) so render regressions can be caught on machines without a GPU.
+/// </summary>
+class RenderBenchmark
+{
+public:
+	struct Settings
+	{
+		// Sprites, spread over the Background, Midground and Foreground layers
+		int sprites = 10000;
+
+		// Generated textures the sprites are spread over
+		int textures = 16;
+
+		// Text labels on the UI layer, only created if a font ID is set and the font is loaded
+		int texts = 200;
+		std::string fontID;
+
+		int warmupFrames = 60;
+		int frames = 600;
+
+		// Pans the camera across the world, so culling sees a different part of the scene every frame
+		bool panCamera = true;
+
+		// Draws on the render thread, so the simulation of a frame overlaps drawing the last one
+		bool renderThread = false;
+
+		// Seed for the scene generator, the same seed always builds the same scene
+		unsigned int seed = 1u;
+	};
+
+	struct Result
+	{
+		int frames = 0;
+		double seconds = 0.0;
+		double framesPerSecond = 0.0;
+		FrameStats::Summary frameTimes;
+
+		// Averages over the measured frames
+		double drawCalls = 0.0;
+		double textureSwitches = 0.0;
+		double batches = 0.0;
+	};
+
+	/// <summary>
+	/// Creates the benchmark textures and entities in the current engine.
+	/// </summary>
+	/// <param name="settings">The benchmark settings</param>
+	static void createScene(const Settings& settings);
+
+	/// <summary>
+	/// Creates the scene, then runs the warm-up and measured frames through the regular engine loop.
+	/// </summary>
+	/// <param name="settings">The benchmark settings</param>
+	/// <returns>The measured frame rate, frame times and draw statistics</returns>
+	static Result run(const Settings& settings);
+
+	/// <summary>
+	/// Prints a result in a format that is easy to read and to diff between runs.
+	/// </summary>
+	/// <param name="stream">The stream to print to</param>
+	/// <param name="result">The benchmark result</param>
+	static void print(std::ostream& stream, const Result& result);
+};
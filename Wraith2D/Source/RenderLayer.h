@@ -7,5 +7,27 @@ enum RenderLayer
 	Foreground,
 	UI,
 
-	Count
-};
\ No newline at end of file
+	// Number of built-in layers. Layers registered at runtime take the IDs from here on
+	Count,
+
+	MaxLayers = 32
+};
+
+/// <summary>
+/// How the renderables of a layer are ordered before drawing.
+/// </summary>
+enum class LayerSortMode
+{
+	// Drawn in the order the renderables were created, depth and texture are ignored
+	None,
+
+	// Sorted by depth, then by texture
+	Depth,
+
+	// Sorted by the bottom edge of their dstRect, so lower renderables are drawn in front, for top-down games.
+	// The order of the last frame is reused, so only renderables that moved past each other are re-sorted
+	Y,
+
+	// Sorted by texture only, for the fewest texture switches when the overlap order doesn't matter
+	Texture
+};
@@ -0,0 +1,144 @@
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <climits>
+
+namespace
+{
+	bool contains(const SDL_Rect& outer, const SDL_Rect& inner)
+	{
+		return inner.x >= outer.x && inner.y >= outer.y
+			&& inner.x + inner.w <= outer.x + outer.w
+			&& inner.y + inner.h <= outer.y + outer.h;
+	}
+}
+
+AtlasPacker::AtlasPacker(int width, int height, int padding)
+	: _width(width)
+	, _height(height)
+	, _padding(padding)
+{
+	// Padding is added to the right and bottom of every rect, so give the page the same margin on the other sides
+	_freeRects.push_back({ padding, padding, width - padding, height - padding });
+}
+
+bool AtlasPacker::insert(int width, int height, SDL_Rect& result)
+{
+	int paddedWidth = width + _padding;
+	int paddedHeight = height + _padding;
+
+	int bestShortSide = INT_MAX;
+	int bestLongSide = INT_MAX;
+	const SDL_Rect* best = nullptr;
+
+	for (const SDL_Rect& freeRect : _freeRects)
+	{
+		if (freeRect.w < paddedWidth || freeRect.h < paddedHeight)
+		{
+			continue;
+		}
+
+		int leftoverX = freeRect.w - paddedWidth;
+		int leftoverY = freeRect.h - paddedHeight;
+		int shortSide = SDL_min(leftoverX, leftoverY);
+		int longSide = SDL_max(leftoverX, leftoverY);
+
+		if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+		{
+			best = &freeRect;
+			bestShortSide = shortSide;
+			bestLongSide = longSide;
+		}
+	}
+
+	if (best == nullptr)
+	{
+		return false;
+	}
+
+	SDL_Rect used = { best->x, best->y, paddedWidth, paddedHeight };
+	splitFreeRects(used);
+	pruneFreeRects();
+
+	result = { used.x, used.y, width, height };
+	_usedArea += static_cast<long long>(width) * height;
+
+	return true;
+}
+
+float AtlasPacker::occupancy() const
+{
+	return static_cast<float>(_usedArea) / (static_cast<float>(_width) * _height);
+}
+
+void AtlasPacker::splitFreeRects(const SDL_Rect& used)
+{
+	// Every free rect overlapping the used one is replaced by up to four maximal rects around it
+	std::size_t kept = 0u;
+	for (std::size_t i = 0; i < _freeRects.size(); i++)
+	{
+		SDL_Rect freeRect = _freeRects[i];
+
+		if (!SDL_HasIntersection(&freeRect, &used))
+		{
+			_freeRects[kept++] = freeRect;
+			continue;
+		}
+
+		if (used.x > freeRect.x)
+		{
+			_splitRects.push_back({ freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.h });
+		}
+
+		if (used.x + used.w < freeRect.x + freeRect.w)
+		{
+			_splitRects.push_back({ used.x + used.w, freeRect.y, freeRect.x + freeRect.w - (used.x + used.w), freeRect.h });
+		}
+
+		if (used.y > freeRect.y)
+		{
+			_splitRects.push_back({ freeRect.x, freeRect.y, freeRect.w, used.y - freeRect.y });
+		}
+
+		if (used.y + used.h < freeRect.y + freeRect.h)
+		{
+			_splitRects.push_back({ freeRect.x, used.y + used.h, freeRect.w, freeRect.y + freeRect.h - (used.y + used.h) });
+		}
+	}
+
+	_freeRects.resize(kept);
+	_freeRects.insert(_freeRects.end(), _splitRects.begin(), _splitRects.end());
+	_splitRects.clear();
+}
+
+void AtlasPacker::pruneFreeRects()
+{
+	// Mark every free rect fully contained in another one, then drop them all at once
+	for (std::size_t i = 0; i < _freeRects.size(); i++)
+	{
+		if (_freeRects[i].w == 0)
+		{
+			continue;
+		}
+
+		for (std::size_t j = i + 1; j < _freeRects.size(); j++)
+		{
+			if (_freeRects[j].w == 0)
+			{
+				continue;
+			}
+
+			if (contains(_freeRects[i], _freeRects[j]))
+			{
+				_freeRects[j].w = 0;
+			}
+			else if (contains(_freeRects[j], _freeRects[i]))
+			{
+				_freeRects[i].w = 0;
+				break;
+			}
+		}
+	}
+
+	_freeRects.erase(std::remove_if(_freeRects.begin(), _freeRects.end(), [](const SDL_Rect& rect) { return rect.w == 0; }), _freeRects.end());
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+/// <summary>
+/// Packs rectangles into a fixed-size page using the MaxRects algorithm with the best short side fit heuristic.
+/// Only deals with sizes, so it can be used at load time or by an offline tool.
+/// </summary>
+class AtlasPacker
+{
+public:
+	/// <summary>
+	/// Creates an empty page.
+	/// </summary>
+	/// <param name="width">The width of the page</param>
+	/// <param name="height">The height of the page</param>
+	/// <param name="padding">The space left between packed rectangles, so filtering doesn't bleed into neighbours</param>
+	AtlasPacker(int width, int height, int padding = 2);
+
+	/// <summary>
+	/// Finds a place for a rectangle and marks it as used.
+	/// </summary>
+	/// <param name="width">The width of the rectangle</param>
+	/// <param name="height">The height of the rectangle</param>
+	/// <param name="result">The position and size of the rectangle inside the page</param>
+	/// <returns>True if it fit, false if the page has no room for it</returns>
+	bool insert(int width, int height, SDL_Rect& result);
+
+	/// <summary>
+	/// Returns the ratio of the page area covered by packed rectangles.
+	/// </summary>
+	/// <returns>The occupancy, between 0 and 1</returns>
+	float occupancy() const;
+
+	inline int width() const { return _width; }
+	inline int height() const { return _height; }
+
+private:
+	int _width;
+	int _height;
+	int _padding;
+	long long _usedArea = 0;
+
+	std::vector<SDL_Rect> _freeRects;
+	std::vector<SDL_Rect> _splitRects;
+
+	void splitFreeRects(const SDL_Rect& used);
+	void pruneFreeRects();
+};
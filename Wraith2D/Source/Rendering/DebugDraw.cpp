@@ -0,0 +1,276 @@
+#include "DebugDraw.h"
+
+#ifdef WRAITH2D_DEBUG_DRAW_ENABLED
+
+#include <algorithm>
+#include <cmath>
+
+#include "../AssetManager.h"
+
+namespace
+{
+	DebugDrawList s_list;
+	std::string s_fontID;
+
+	// Reused between flushes for the primitives converted to the screen
+	std::vector<SDL_FPoint> s_screenPoints;
+	std::vector<SDL_FRect> s_screenRects;
+	std::vector<DebugDrawList::Fill> s_screenFills;
+	std::vector<DebugDrawList::Fill> s_lineRects;
+
+	std::vector<TexturedQuad> s_glyphQuads;
+
+	uint32_t packColor(const SDL_Color& color)
+	{
+		return static_cast<uint32_t>(color.r) << 24 | color.g << 16 | color.b << 8 | color.a;
+	}
+
+	// Draws screen rects with one call per color, sorting them by color in place
+	void fillByColor(SDL_Renderer* renderer, std::vector<DebugDrawList::Fill>& fills)
+	{
+		std::stable_sort(fills.begin(), fills.end(), [](const DebugDrawList::Fill& a, const DebugDrawList::Fill& b) { return packColor(a.color) < packColor(b.color); });
+
+		for (std::size_t first = 0u; first < fills.size();)
+		{
+			const SDL_Color& color = fills[first].color;
+			s_screenRects.clear();
+
+			std::size_t last = first;
+			for (; last < fills.size() && packColor(fills[last].color) == packColor(color); last++)
+			{
+				s_screenRects.emplace_back(fills[last].rect);
+			}
+
+			SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+			SDL_RenderFillRectsF(renderer, s_screenRects.data(), static_cast<int>(s_screenRects.size()));
+			first = last;
+		}
+	}
+
+	// The pixels of a horizontal or vertical screen segment as a rect one pixel thick. The end pixel is left out unless asked for,
+	// so the segments of a polyline don't overlap at their corners and translucent outlines blend evenly
+	bool axisAlignedRect(const SDL_FPoint& from, const SDL_FPoint& to, bool includeEnd, SDL_FRect& rect)
+	{
+		float fromX = std::floor(from.x);
+		float fromY = std::floor(from.y);
+		float toX = std::floor(to.x);
+		float toY = std::floor(to.y);
+
+		if (fromY == toY)
+		{
+			float length = std::fabs(toX - fromX) + (includeEnd ? 1.f : 0.f);
+			float left = toX < fromX ? fromX - length + 1.f : fromX;
+			rect = SDL_FRect{ left, fromY, length, 1.f };
+			return true;
+		}
+
+		if (fromX == toX)
+		{
+			float length = std::fabs(toY - fromY) + (includeEnd ? 1.f : 0.f);
+			float top = toY < fromY ? fromY - length + 1.f : fromY;
+			rect = SDL_FRect{ fromX, top, 1.f, length };
+			return true;
+		}
+
+		return false;
+	}
+}
+
+void DebugDraw::line(const Vector2& from, const Vector2& to, const SDL_Color& color)
+{
+	SDL_FPoint points[2] = { { from.x, from.y }, { to.x, to.y } };
+	addPolyline(points, 2u, color);
+}
+
+void DebugDraw::rect(const SDL_Rect& rect, const SDL_Color& color)
+{
+	float left = static_cast<float>(rect.x);
+	float top = static_cast<float>(rect.y);
+	float right = static_cast<float>(rect.x + rect.w);
+	float bottom = static_cast<float>(rect.y + rect.h);
+
+	SDL_FPoint points[5] = { { left, top }, { right, top }, { right, bottom }, { left, bottom }, { left, top } };
+	addPolyline(points, 5u, color);
+}
+
+void DebugDraw::fillRect(const SDL_Rect& rect, const SDL_Color& color)
+{
+	s_list.fills.emplace_back(DebugDrawList::Fill{ { static_cast<float>(rect.x), static_cast<float>(rect.y), static_cast<float>(rect.w), static_cast<float>(rect.h) }, color });
+}
+
+void DebugDraw::circle(const Vector2& center, float radius, const SDL_Color& color)
+{
+	constexpr int MAX_SEGMENTS = 64;
+	constexpr float TWO_PI = 6.28318530718f;
+
+	// Small circles don't need many segments to look round
+	int segments = SDL_max(12, SDL_min(static_cast<int>(radius / 4.f), MAX_SEGMENTS));
+
+	SDL_FPoint points[MAX_SEGMENTS + 1];
+	for (int i = 0; i < segments; i++)
+	{
+		float angle = TWO_PI * i / segments;
+		points[i] = SDL_FPoint{ center.x + std::cos(angle) * radius, center.y + std::sin(angle) * radius };
+	}
+	points[segments] = points[0];
+
+	addPolyline(points, static_cast<std::size_t>(segments) + 1u, color);
+}
+
+void DebugDraw::grid(const SDL_Rect& area, int cellSize, const SDL_Color& color)
+{
+	if (cellSize <= 0)
+	{
+		return;
+	}
+
+	float top = static_cast<float>(area.y);
+	float bottom = static_cast<float>(area.y + area.h);
+	for (int x = area.x; x <= area.x + area.w; x += cellSize)
+	{
+		line(Vector2(static_cast<float>(x), top), Vector2(static_cast<float>(x), bottom), color);
+	}
+
+	float left = static_cast<float>(area.x);
+	float right = static_cast<float>(area.x + area.w);
+	for (int y = area.y; y <= area.y + area.h; y += cellSize)
+	{
+		line(Vector2(left, static_cast<float>(y)), Vector2(right, static_cast<float>(y)), color);
+	}
+}
+
+void DebugDraw::text(const Vector2& position, const std::string& text, const SDL_Color& color)
+{
+	if (s_fontID.empty())
+	{
+		return;
+	}
+
+	GlyphAtlas* glyphAtlas = AssetManager::instance().getGlyphAtlas(s_fontID);
+	if (glyphAtlas == nullptr)
+	{
+		return;
+	}
+
+	int width = 0;
+	int height = 0;
+	glyphAtlas->layout(text, 0u, s_glyphQuads, width, height);
+
+	int x = static_cast<int>(std::round(position.x));
+	int y = static_cast<int>(std::round(position.y));
+
+	for (const TexturedQuad& quad : s_glyphQuads)
+	{
+		DrawCommand command;
+		command.texture = quad.texture;
+		command.srcRect = quad.srcRect;
+		command.hasSrcRect = true;
+		command.dstRect = { x + quad.dstRect.x, y + quad.dstRect.y, quad.dstRect.w, quad.dstRect.h };
+		command.color = color;
+		s_list.text.submit(command, RenderLayer::UI, 0);
+	}
+}
+
+void DebugDraw::setFont(const std::string& fontID)
+{
+	s_fontID = fontID;
+}
+
+void DebugDraw::clear()
+{
+	s_list.clear();
+}
+
+const DebugDrawList& DebugDraw::list()
+{
+	return s_list;
+}
+
+void DebugDraw::flushShapes(SDL_Renderer* renderer, DebugDrawList& list, const SDL_Point& origin, float zoom)
+{
+	if (list.polylines.empty() && list.fills.empty())
+	{
+		return;
+	}
+
+	auto toScreen = [&](float x, float y) { return SDL_FPoint{ (x - origin.x) * zoom, (y - origin.y) * zoom }; };
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+	// Fills of one color go out in a single call
+	s_screenFills.clear();
+	for (const DebugDrawList::Fill& fill : list.fills)
+	{
+		SDL_FPoint topLeft = toScreen(fill.rect.x, fill.rect.y);
+		s_screenFills.emplace_back(DebugDrawList::Fill{ { topLeft.x, topLeft.y, fill.rect.w * zoom, fill.rect.h * zoom }, fill.color });
+	}
+	fillByColor(renderer, s_screenFills);
+
+	// Horizontal and vertical segments, most of the rects and grids, become thin rects drawn with one call per color.
+	// Runs of the other segments are connected, so each run is one call, and the color only changes between colors
+	std::stable_sort(list.polylines.begin(), list.polylines.end(), [](const DebugDrawList::Polyline& a, const DebugDrawList::Polyline& b) { return packColor(a.color) < packColor(b.color); });
+	s_lineRects.clear();
+	uint32_t currentColor = 0u;
+	bool colorSet = false;
+
+	auto flushRun = [&](const SDL_Color& color)
+	{
+		if (s_screenPoints.size() >= 2u)
+		{
+			if (!colorSet || packColor(color) != currentColor)
+			{
+				SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+				currentColor = packColor(color);
+				colorSet = true;
+			}
+
+			SDL_RenderDrawLinesF(renderer, s_screenPoints.data(), static_cast<int>(s_screenPoints.size()));
+		}
+
+		s_screenPoints.clear();
+	};
+
+	for (const DebugDrawList::Polyline& polyline : list.polylines)
+	{
+		const SDL_FPoint* points = list.points.data() + polyline.firstPoint;
+		bool closed = polyline.pointCount > 2u && points[0].x == points[polyline.pointCount - 1u].x && points[0].y == points[polyline.pointCount - 1u].y;
+
+		s_screenPoints.clear();
+		SDL_FPoint from = toScreen(points[0].x, points[0].y);
+		for (uint32_t i = 1; i < polyline.pointCount; i++)
+		{
+			SDL_FPoint to = toScreen(points[i].x, points[i].y);
+
+			SDL_FRect rect;
+			if (axisAlignedRect(from, to, !closed && i == polyline.pointCount - 1u, rect))
+			{
+				flushRun(polyline.color);
+				s_lineRects.emplace_back(DebugDrawList::Fill{ rect, polyline.color });
+			}
+			else
+			{
+				if (s_screenPoints.empty())
+				{
+					s_screenPoints.emplace_back(from);
+				}
+				s_screenPoints.emplace_back(to);
+			}
+
+			from = to;
+		}
+
+		flushRun(polyline.color);
+	}
+
+	fillByColor(renderer, s_lineRects);
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+void DebugDraw::addPolyline(const SDL_FPoint* points, std::size_t count, const SDL_Color& color)
+{
+	s_list.polylines.emplace_back(DebugDrawList::Polyline{ static_cast<uint32_t>(s_list.points.size()), static_cast<uint32_t>(count), color });
+	s_list.points.insert(s_list.points.end(), points, points + count);
+}
+
+#endif
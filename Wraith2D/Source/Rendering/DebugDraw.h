@@ -0,0 +1,153 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "RenderQueue.h"
+#include "../Math/Vector2.h"
+
+/**
+* Debug primitives are only recorded in debug builds, or when WRAITH2D_DEBUG_DRAW is defined.
+* Otherwise the macros below compile to nothing, arguments included, and nothing is drawn.
+*/
+#if defined(_DEBUG) || defined(WRAITH2D_DEBUG_DRAW)
+#define WRAITH2D_DEBUG_DRAW_ENABLED
+#define DEBUG_DRAW_LINE(from, to, color) DebugDraw::line(from, to, color)
+#define DEBUG_DRAW_RECT(rect, color) DebugDraw::rect(rect, color)
+#define DEBUG_DRAW_FILL_RECT(rect, color) DebugDraw::fillRect(rect, color)
+#define DEBUG_DRAW_CIRCLE(center, radius, color) DebugDraw::circle(center, radius, color)
+#define DEBUG_DRAW_GRID(area, cellSize, color) DebugDraw::grid(area, cellSize, color)
+#define DEBUG_DRAW_TEXT(position, text, color) DebugDraw::text(position, text, color)
+#define DEBUG_DRAW_CLEAR() DebugDraw::clear()
+#else
+#define DEBUG_DRAW_LINE(from, to, color)
+#define DEBUG_DRAW_RECT(rect, color)
+#define DEBUG_DRAW_FILL_RECT(rect, color)
+#define DEBUG_DRAW_CIRCLE(center, radius, color)
+#define DEBUG_DRAW_GRID(area, cellSize, color)
+#define DEBUG_DRAW_TEXT(position, text, color)
+#define DEBUG_DRAW_CLEAR()
+#endif
+
+/// <summary>
+/// The debug primitives of a frame in world coordinates, kept in flat arrays so they are drawn in a few batched calls.
+/// </summary>
+struct DebugDrawList
+{
+	struct Polyline
+	{
+		uint32_t firstPoint;
+		uint32_t pointCount;
+		SDL_Color color;
+	};
+
+	struct Fill
+	{
+		SDL_FRect rect;
+		SDL_Color color;
+	};
+
+	std::vector<SDL_FPoint> points;
+	std::vector<Polyline> polylines;
+	std::vector<Fill> fills;
+
+	// Glyph quads of the debug text, sorted before drawing
+	RenderQueue text;
+
+	void clear()
+	{
+		points.clear();
+		polylines.clear();
+		fills.clear();
+		text.clear();
+	}
+
+	bool empty() const { return polylines.empty() && fills.empty() && text.size() == 0u; }
+};
+
+/// <summary>
+/// Immediate-mode debug drawing of lines, rects, circles and text, drawn over every camera after the world.
+/// Use the DEBUG_DRAW macros, so release builds don't even evaluate the arguments.
+/// Primitives stay until the next simulation step, so the ones added from fixedUpdate don't flicker on frames without a step.
+/// </summary>
+class DebugDraw
+{
+public:
+	/// <summary>
+	/// Draws a line.
+	/// </summary>
+	/// <param name="from">The start in world coordinates</param>
+	/// <param name="to">The end in world coordinates</param>
+	/// <param name="color">The color</param>
+	static void line(const Vector2& from, const Vector2& to, const SDL_Color& color);
+
+	/// <summary>
+	/// Draws the outline of a rect.
+	/// </summary>
+	/// <param name="rect">The rect in world coordinates</param>
+	/// <param name="color">The color</param>
+	static void rect(const SDL_Rect& rect, const SDL_Color& color);
+
+	/// <summary>
+	/// Draws a filled rect. Use a translucent color to keep what is below visible.
+	/// </summary>
+	/// <param name="rect">The rect in world coordinates</param>
+	/// <param name="color">The color</param>
+	static void fillRect(const SDL_Rect& rect, const SDL_Color& color);
+
+	/// <summary>
+	/// Draws the outline of a circle.
+	/// </summary>
+	/// <param name="center">The center in world coordinates</param>
+	/// <param name="radius">The radius in world units</param>
+	/// <param name="color">The color</param>
+	static void circle(const Vector2& center, float radius, const SDL_Color& color);
+
+	/// <summary>
+	/// Draws the lines of a grid over an area.
+	/// </summary>
+	/// <param name="area">The area in world coordinates</param>
+	/// <param name="cellSize">The width and height of each cell</param>
+	/// <param name="color">The color</param>
+	static void grid(const SDL_Rect& area, int cellSize, const SDL_Color& color);
+
+	/// <summary>
+	/// Draws a line of text with the font set by setFont. Nothing is drawn until a font is set.
+	/// </summary>
+	/// <param name="position">The top left corner in world coordinates</param>
+	/// <param name="text">The text</param>
+	/// <param name="color">The color</param>
+	static void text(const Vector2& position, const std::string& text, const SDL_Color& color);
+
+	/// <summary>
+	/// Sets the font debug text is drawn with.
+	/// </summary>
+	/// <param name="fontID">The ID of a loaded font</param>
+	static void setFont(const std::string& fontID);
+
+	/// <summary>
+	/// Removes every primitive. Called by the engine before the first simulation step of a frame.
+	/// </summary>
+	static void clear();
+
+	/// <summary>
+	/// Returns the primitives recorded so far.
+	/// </summary>
+	/// <returns>The debug draw list</returns>
+	static const DebugDrawList& list();
+
+	/// <summary>
+	/// Draws a list into the current viewport. Fills and horizontal or vertical lines are drawn one call per color,
+	/// the other lines one call per connected run.
+	/// </summary>
+	/// <param name="renderer">The SDL Renderer</param>
+	/// <param name="list">The list, its primitives are grouped by color in place</param>
+	/// <param name="origin">The world position drawn at the top left corner of the viewport</param>
+	/// <param name="zoom">The scale the world is drawn at</param>
+	static void flushShapes(SDL_Renderer* renderer, DebugDrawList& list, const SDL_Point& origin, float zoom);
+
+private:
+	static void addPolyline(const SDL_FPoint* points, std::size_t count, const SDL_Color& color);
+};
@@ -0,0 +1,57 @@
+#include "DynamicResolution.h"
+
+#include <SDL.h>
+#include <cmath>
+
+void DynamicResolution::setEnabled(bool enabled)
+{
+	_enabled = enabled;
+	_scale = SDL_max(_settings.minScale, SDL_min(1.f, _settings.maxScale));
+	_smoothedFrameTime = 0.0;
+	_cooldown = 0;
+}
+
+void DynamicResolution::setSettings(const Settings& settings)
+{
+	_settings = settings;
+	_settings.minScale = SDL_max(settings.minScale, 0.1f);
+	_settings.maxScale = SDL_max(settings.maxScale, _settings.minScale);
+	_scale = SDL_max(_settings.minScale, SDL_min(_scale, _settings.maxScale));
+}
+
+void DynamicResolution::update(double frameTime, double limiterFrameTime)
+{
+	double target = _settings.targetFrameTime > 0.0 ? _settings.targetFrameTime : limiterFrameTime;
+	if (!_enabled || target <= 0.0 || frameTime <= 0.0 || frameTime > MAX_FRAME_TIME)
+	{
+		return;
+	}
+
+	_smoothedFrameTime = _smoothedFrameTime > 0.0 ? _smoothedFrameTime + SMOOTHING * (frameTime - _smoothedFrameTime) : frameTime;
+
+	if (_cooldown > 0)
+	{
+		_cooldown--;
+		return;
+	}
+
+	float scale = _scale;
+	if (_smoothedFrameTime > target * OVER_BUDGET)
+	{
+		// The fill cost goes with the pixel count, so the scale goes with the square root of the time
+		scale *= static_cast<float>(std::sqrt(target / _smoothedFrameTime));
+	}
+	else if (_smoothedFrameTime < target * UNDER_BUDGET)
+	{
+		scale *= STEP_UP;
+	}
+
+	scale = std::round(scale * SCALE_GRANULARITY) / SCALE_GRANULARITY;
+	scale = SDL_max(_settings.minScale, SDL_min(scale, _settings.maxScale));
+
+	if (scale != _scale)
+	{
+		_scale = scale;
+		_cooldown = _settings.cooldownFrames;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+/// <summary>
+/// Picks the resolution scale the world is rendered at, lowering it when frames take longer than the target
+/// frame time and raising it again once there is headroom.
+/// </summary>
+class DynamicResolution
+{
+public:
+	struct Settings
+	{
+		// Bounds of the scale, relative to the output resolution
+		float minScale = 0.5f;
+		float maxScale = 1.f;
+
+		// Frame time to hold, in seconds. 0 follows the target of the frame limiter
+		double targetFrameTime = 0.0;
+
+		// Frames to wait after a change, so it shows up in the measured frame time before the next one
+		int cooldownFrames = 15;
+	};
+
+	/// <summary>
+	/// Enables or disables scaling. Disabling goes back to full resolution.
+	/// </summary>
+	/// <param name="enabled">Flag to scale the resolution or not</param>
+	void setEnabled(bool enabled);
+
+	/// <summary>
+	/// Checks whether the resolution is scaled.
+	/// </summary>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isEnabled() const { return _enabled; }
+
+	/// <summary>
+	/// Changes the bounds and the target. The scale is clamped to the new bounds.
+	/// </summary>
+	/// <param name="settings">The new settings</param>
+	void setSettings(const Settings& settings);
+
+	/// <summary>
+	/// Returns the current settings.
+	/// </summary>
+	/// <returns>The settings</returns>
+	inline const Settings& getSettings() const { return _settings; }
+
+	/// <summary>
+	/// Feeds the time the last frame took and adjusts the scale.
+	/// </summary>
+	/// <param name="frameTime">The time the last frame spent working, in seconds, without waiting for vsync</param>
+	/// <param name="limiterFrameTime">The target frame time of the frame limiter, in seconds, or 0 if it isn't limiting</param>
+	void update(double frameTime, double limiterFrameTime);
+
+	/// <summary>
+	/// Returns the scale the world is rendered at.
+	/// </summary>
+	/// <returns>The scale, 1 for the output resolution</returns>
+	inline float scale() const { return _enabled ? _scale : 1.f; }
+
+private:
+	// Longer frames are loading hitches, not rendering load
+	static constexpr double MAX_FRAME_TIME = 0.25;
+	static constexpr double SMOOTHING = 0.2;
+
+	// Over the target by more than this lowers the scale, under it by more than this raises it
+	static constexpr double OVER_BUDGET = 1.02;
+	static constexpr double UNDER_BUDGET = 0.85;
+	static constexpr float STEP_UP = 1.05f;
+
+	// Scales snap to steps of 1/64, so tiny changes don't cause a resize
+	static constexpr float SCALE_GRANULARITY = 64.f;
+
+	Settings _settings;
+	bool _enabled = false;
+	float _scale = 1.f;
+	double _smoothedFrameTime = 0.0;
+	int _cooldown = 0;
+};
@@ -0,0 +1,198 @@
+#include "GlyphAtlas.h"
+
+#include <iostream>
+
+#include "../Engine.h"
+
+GlyphAtlas::GlyphAtlas(SDL_Renderer* renderer, TTF_Font* font, int pageSize)
+	: _renderer(renderer)
+	, _font(font)
+	, _pageSize(pageSize)
+	, _lineSkip(TTF_FontLineSkip(font))
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+	for (auto& page : _pages)
+	{
+		SDL_DestroyTexture(page);
+	}
+}
+
+void GlyphAtlas::layout(const std::string& text, unsigned int wrapLength, std::vector<TexturedQuad>& quads, int& width, int& height)
+{
+	quads.clear();
+	width = 0;
+	height = _lineSkip;
+
+	int penX = 0;
+	int penY = 0;
+	std::size_t index = 0;
+
+	// Kerning only applies between glyphs on the same line
+	unsigned char previous = 0;
+
+	while (index < text.size())
+	{
+		unsigned char character = static_cast<unsigned char>(text[index]);
+
+		if (character == '\n')
+		{
+			penX = 0;
+			penY += _lineSkip;
+			height = penY + _lineSkip;
+			previous = 0;
+			index++;
+			continue;
+		}
+
+		// Break before a word that would cross the wrap length, unless it starts the line
+		if (wrapLength > 0u && character != ' ' && (index == 0 || text[index - 1] == ' '))
+		{
+			std::size_t wordEnd = text.find_first_of(" \n", index);
+			wordEnd = wordEnd == std::string::npos ? text.size() : wordEnd;
+
+			if (penX > 0 && penX + wordWidth(text, index, wordEnd) > static_cast<int>(wrapLength))
+			{
+				penX = 0;
+				penY += _lineSkip;
+				height = penY + _lineSkip;
+				previous = 0;
+			}
+		}
+
+		// Pairs like "AV" overlap, as TTF_RenderText draws them
+		penX += kerning(previous, character);
+
+		const Glyph& current = glyph(character);
+		if (current.texture != nullptr)
+		{
+			TexturedQuad quad;
+			quad.texture = current.texture;
+			quad.srcRect = current.rect;
+			quad.dstRect = { penX + current.offsetX, penY, current.rect.w, current.rect.h };
+			quads.push_back(quad);
+		}
+
+		penX += current.advance;
+		width = SDL_max(width, penX);
+		previous = character;
+		index++;
+	}
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::glyph(unsigned char character)
+{
+	Glyph& glyph = _glyphs[character];
+	if (glyph.loaded)
+	{
+		return glyph;
+	}
+
+	glyph.loaded = true;
+
+	int minX = 0;
+	int maxX = 0;
+	int minY = 0;
+	int maxY = 0;
+	if (TTF_GlyphMetrics(_font, character, &minX, &maxX, &minY, &maxY, &glyph.advance) != 0)
+	{
+		return glyph;
+	}
+
+	// Whitespace only advances the pen
+	if (maxX <= minX || character == ' ')
+	{
+		return glyph;
+	}
+
+	// The glyph is rendered as a full line height cell, shifted left when it overhangs the pen position
+	SDL_Surface* rendered = TTF_RenderGlyph_Blended(_font, character, SDL_Color{ 255, 255, 255, 255 });
+	if (rendered == nullptr)
+	{
+		std::cerr << "Failed to render glyph! Error: " << TTF_GetError() << std::endl;
+		return glyph;
+	}
+
+	SDL_Surface* surface = SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_ARGB8888, 0);
+	SDL_FreeSurface(rendered);
+
+	if (surface != nullptr)
+	{
+		glyph.offsetX = SDL_min(minX, 0);
+		addToPage(surface, glyph);
+		SDL_FreeSurface(surface);
+	}
+
+	return glyph;
+}
+
+bool GlyphAtlas::addToPage(SDL_Surface* surface, Glyph& glyph)
+{
+	auto rendererLock = Engine::instance().lockRenderer();
+
+	for (std::size_t page = 0; page < _packers.size(); page++)
+	{
+		if (_packers[page].insert(surface->w, surface->h, glyph.rect))
+		{
+			glyph.texture = _pages[page];
+			SDL_UpdateTexture(glyph.texture, &glyph.rect, surface->pixels, surface->pitch);
+			return true;
+		}
+	}
+
+	AtlasPacker packer(_pageSize, _pageSize, 1);
+	if (!packer.insert(surface->w, surface->h, glyph.rect))
+	{
+		std::cerr << "Glyph is too large for the glyph atlas" << std::endl;
+		return false;
+	}
+
+	SDL_Texture* page = SDL_CreateTexture(_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, _pageSize, _pageSize);
+	if (page == nullptr)
+	{
+		std::cerr << "Failed to create glyph atlas page! Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	// Static textures start out undefined, clear the padding so filtering doesn't pick up garbage
+	std::vector<Uint32> clearPixels(static_cast<std::size_t>(_pageSize) * _pageSize, 0u);
+	SDL_UpdateTexture(page, nullptr, clearPixels.data(), _pageSize * static_cast<int>(sizeof(Uint32)));
+	SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+
+	_pages.push_back(page);
+	_packers.push_back(packer);
+
+	glyph.texture = page;
+	SDL_UpdateTexture(glyph.texture, &glyph.rect, surface->pixels, surface->pitch);
+
+	return true;
+}
+
+int GlyphAtlas::wordWidth(const std::string& text, std::size_t begin, std::size_t end)
+{
+	int width = 0;
+	for (std::size_t i = begin; i < end; i++)
+	{
+		unsigned char character = static_cast<unsigned char>(text[i]);
+		width += glyph(character).advance;
+
+		if (i > begin)
+		{
+			width += kerning(static_cast<unsigned char>(text[i - 1]), character);
+		}
+	}
+
+	return width;
+}
+
+int GlyphAtlas::kerning(unsigned char previous, unsigned char character) const
+{
+	if (previous == 0 || TTF_GetFontKerning(_font) == 0)
+	{
+		return 0;
+	}
+
+	return TTF_GetFontKerningSizeGlyphs(_font, previous, character);
+}
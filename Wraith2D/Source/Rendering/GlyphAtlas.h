@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AtlasPacker.h"
+#include "RenderQueue.h"
+
+/// <summary>
+/// Caches the rasterized glyphs of a font in atlas pages, so text can be laid out as quads
+/// without rasterizing or creating textures. Glyphs are rendered white and tinted when drawn.
+/// </summary>
+class GlyphAtlas
+{
+public:
+	/// <summary>
+	/// Creates an empty glyph atlas. Glyphs are rasterized the first time they are laid out.
+	/// </summary>
+	/// <param name="renderer">The SDL Renderer that owns the atlas pages</param>
+	/// <param name="font">The font</param>
+	/// <param name="pageSize">The width and height of each atlas page</param>
+	GlyphAtlas(SDL_Renderer* renderer, TTF_Font* font, int pageSize = 512);
+	~GlyphAtlas();
+
+	GlyphAtlas(const GlyphAtlas&) = delete;
+	GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+
+	/// <summary>
+	/// Lays out a Latin-1 string, like TTF_RenderText_Blended_Wrapped, as one white quad per visible glyph.
+	/// </summary>
+	/// <param name="text">The text</param>
+	/// <param name="wrapLength">The width in pixels at which lines are wrapped between words, or 0 to only break at newlines</param>
+	/// <param name="quads">Filled with the glyph quads, relative to the top left corner of the text</param>
+	/// <param name="width">The width of the laid out text</param>
+	/// <param name="height">The height of the laid out text</param>
+	void layout(const std::string& text, unsigned int wrapLength, std::vector<TexturedQuad>& quads, int& width, int& height);
+
+private:
+	struct Glyph
+	{
+		SDL_Texture* texture = nullptr;
+		SDL_Rect rect = { 0, 0, 0, 0 };
+		int offsetX = 0;
+		int advance = 0;
+		bool loaded = false;
+	};
+
+	SDL_Renderer* _renderer;
+	TTF_Font* _font;
+	int _pageSize;
+	int _lineSkip;
+
+	Glyph _glyphs[256];
+
+	std::vector<SDL_Texture*> _pages;
+	std::vector<AtlasPacker> _packers;
+
+	const Glyph& glyph(unsigned char character);
+	bool addToPage(SDL_Surface* surface, Glyph& glyph);
+	int wordWidth(const std::string& text, std::size_t begin, std::size_t end);
+
+	// The offset between two consecutive glyphs, 0 when the font has kerning disabled or there is no previous glyph
+	int kerning(unsigned char previous, unsigned char character) const;
+};
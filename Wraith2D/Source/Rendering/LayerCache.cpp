@@ -0,0 +1,97 @@
+#include "LayerCache.h"
+
+#include <iostream>
+
+#include "../Engine.h"
+
+LayerCache::~LayerCache()
+{
+	disable();
+}
+
+void LayerCache::enable(int worldWidth, int worldHeight)
+{
+	disable();
+
+	_enabled = true;
+	_columns = SDL_max((worldWidth + TILE_SIZE - 1) / TILE_SIZE, 1);
+	_rows = SDL_max((worldHeight + TILE_SIZE - 1) / TILE_SIZE, 1);
+
+	// Tile textures are only created once they come into view
+	_tiles.resize(static_cast<std::size_t>(_columns) * _rows);
+}
+
+void LayerCache::disable()
+{
+	for (auto& tile : _tiles)
+	{
+		if (tile.texture != nullptr)
+		{
+			Engine::instance().destroyTexture(tile.texture);
+		}
+	}
+
+	_tiles.clear();
+	_columns = 0;
+	_rows = 0;
+	_enabled = false;
+}
+
+void LayerCache::invalidate(const SDL_Rect& area)
+{
+	forEachTile(area, [](Tile& tile, const SDL_Rect&) { tile.dirty = true; });
+}
+
+void LayerCache::invalidateAll()
+{
+	for (auto& tile : _tiles)
+	{
+		tile.dirty = true;
+	}
+}
+
+void LayerCache::submit(RenderQueue& queue, RenderLayer layer, const SDL_Rect& view)
+{
+	forEachTile(view, [&](Tile& tile, const SDL_Rect& tileRect)
+		{
+			if (tile.texture == nullptr || tile.dirty)
+			{
+				return;
+			}
+
+			DrawCommand command;
+			command.texture = tile.texture;
+			command.dstRect = tileRect;
+			queue.submit(command, layer, 0);
+		});
+}
+
+bool LayerCache::prepareTile(SDL_Renderer* renderer, Tile& tile)
+{
+	if (tile.texture != nullptr)
+	{
+		return true;
+	}
+
+	auto rendererLock = Engine::instance().lockRenderer();
+
+	tile.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, TILE_SIZE, TILE_SIZE);
+	if (tile.texture == nullptr)
+	{
+		std::cerr << "Failed to create layer cache tile! Error: " << SDL_GetError() << std::endl;
+		return false;
+	}
+
+	// Sprites blended onto a transparent target leave it premultiplied, so it has to be drawn with a premultiplied blend
+	SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+	if (SDL_SetTextureBlendMode(tile.texture, premultiplied) != 0)
+	{
+		// Not every renderer supports custom blend modes, translucent edges come out slightly darker with this one
+		SDL_SetTextureBlendMode(tile.texture, SDL_BLENDMODE_BLEND);
+	}
+
+	return true;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+#include "RenderQueue.h"
+
+/// <summary>
+/// Caches a render layer in render target textures, tiled over the game world.
+/// Tiles are rendered when they first come into view and re-rendered only after being invalidated.
+/// </summary>
+class LayerCache
+{
+public:
+	static constexpr int TILE_SIZE = 1024;
+
+	LayerCache() = default;
+	~LayerCache();
+
+	LayerCache(const LayerCache&) = delete;
+	LayerCache& operator=(const LayerCache&) = delete;
+
+	/// <summary>
+	/// Starts caching, covering the game world with tiles. Content outside the world isn't cached.
+	/// </summary>
+	/// <param name="worldWidth">The width of the game world</param>
+	/// <param name="worldHeight">The height of the game world</param>
+	void enable(int worldWidth, int worldHeight);
+
+	/// <summary>
+	/// Stops caching and destroys the tile textures once no frame in flight draws them.
+	/// </summary>
+	void disable();
+
+	/// <summary>
+	/// Checks whether this layer is cached.
+	/// </summary>
+	/// <returns>True if it is, false if not</returns>
+	inline bool isEnabled() const { return _enabled; }
+
+	/// <summary>
+	/// Marks the tiles overlapping an area to be re-rendered.
+	/// </summary>
+	/// <param name="area">The area in world coordinates</param>
+	void invalidate(const SDL_Rect& area);
+
+	/// <summary>
+	/// Marks every tile to be re-rendered.
+	/// </summary>
+	void invalidateAll();
+
+	/// <summary>
+	/// Collects the invalidated tiles in view of a camera, creating their textures the first time.
+	/// Tiles only record what to draw here, they are drawn into when the frame is submitted.
+	/// </summary>
+	/// <typeparam name="RecordTile">A callable taking the tile texture and its world rect, which records the layer relative to it</typeparam>
+	/// <param name="renderer">The SDL Renderer</param>
+	/// <param name="view">The view of the camera in world coordinates</param>
+	/// <param name="recordTile">Records the content of a tile</param>
+	/// <returns>The number of tiles to re-render</returns>
+	template<typename RecordTile>
+	int refresh(SDL_Renderer* renderer, const SDL_Rect& view, RecordTile&& recordTile)
+	{
+		int refreshed = 0;
+
+		forEachTile(view, [&](Tile& tile, const SDL_Rect& tileRect)
+			{
+				if (!tile.dirty || !prepareTile(renderer, tile))
+				{
+					return;
+				}
+
+				recordTile(tile.texture, tileRect);
+
+				tile.dirty = false;
+				refreshed++;
+			});
+
+		return refreshed;
+	}
+
+	/// <summary>
+	/// Adds a draw command in world coordinates for every cached tile in view of a camera.
+	/// </summary>
+	/// <param name="queue">The render queue</param>
+	/// <param name="layer">The layer this cache belongs to</param>
+	/// <param name="view">The view of the camera in world coordinates</param>
+	void submit(RenderQueue& queue, RenderLayer layer, const SDL_Rect& view);
+
+private:
+	struct Tile
+	{
+		SDL_Texture* texture = nullptr;
+		bool dirty = true;
+	};
+
+	bool _enabled = false;
+	int _columns = 0;
+	int _rows = 0;
+	std::vector<Tile> _tiles;
+
+	bool prepareTile(SDL_Renderer* renderer, Tile& tile);
+
+	template<typename Function>
+	void forEachTile(const SDL_Rect& area, Function&& function)
+	{
+		if (area.x + area.w <= 0 || area.y + area.h <= 0)
+		{
+			return;
+		}
+
+		int minColumn = SDL_max(area.x / TILE_SIZE, 0);
+		int minRow = SDL_max(area.y / TILE_SIZE, 0);
+		int maxColumn = SDL_min((area.x + area.w - 1) / TILE_SIZE, _columns - 1);
+		int maxRow = SDL_min((area.y + area.h - 1) / TILE_SIZE, _rows - 1);
+
+		for (int row = minRow; row <= maxRow; row++)
+		{
+			for (int column = minColumn; column <= maxColumn; column++)
+			{
+				SDL_Rect tileRect = { column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE };
+				function(_tiles[row * _columns + column], tileRect);
+			}
+		}
+	}
+};
@@ -0,0 +1,69 @@
+#include "OcclusionGrid.h"
+
+void OcclusionGrid::reset(const SDL_Rect& view)
+{
+	_view = view;
+
+	// Wide views get larger cells, so a row always fits in a mask
+	_cellSize = SDL_max(MIN_CELL_SIZE, (view.w + MAX_COLUMNS - 1) / MAX_COLUMNS);
+	_columns = SDL_max((view.w + _cellSize - 1) / _cellSize, 0);
+	_rows = SDL_max((view.h + _cellSize - 1) / _cellSize, 0);
+
+	_covered.assign(static_cast<std::size_t>(_rows), 0u);
+}
+
+void OcclusionGrid::cover(const SDL_Rect& opaqueRect)
+{
+	int left = opaqueRect.x - _view.x;
+	int top = opaqueRect.y - _view.y;
+	int right = left + opaqueRect.w;
+	int bottom = top + opaqueRect.h;
+
+	// Only whole cells count. Past the edges of the view nothing is drawn, so reaching an edge covers the cells along it
+	int firstColumn = left <= 0 ? 0 : (left + _cellSize - 1) / _cellSize;
+	int firstRow = top <= 0 ? 0 : (top + _cellSize - 1) / _cellSize;
+	int lastColumn = right >= _view.w ? _columns - 1 : (right < 0 ? -1 : right / _cellSize - 1);
+	int lastRow = bottom >= _view.h ? _rows - 1 : (bottom < 0 ? -1 : bottom / _cellSize - 1);
+
+	if (firstColumn > lastColumn || firstRow > lastRow)
+	{
+		return;
+	}
+
+	uint64_t mask = columnMask(firstColumn, lastColumn);
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		_covered[row] |= mask;
+	}
+}
+
+bool OcclusionGrid::isHidden(const SDL_Rect& rect) const
+{
+	int left = SDL_max(rect.x - _view.x, 0);
+	int top = SDL_max(rect.y - _view.y, 0);
+	int right = SDL_min(rect.x + rect.w - _view.x, _view.w);
+	int bottom = SDL_min(rect.y + rect.h - _view.y, _view.h);
+
+	if (left >= right || top >= bottom)
+	{
+		return false;
+	}
+
+	uint64_t mask = columnMask(left / _cellSize, (right - 1) / _cellSize);
+	for (int row = top / _cellSize; row <= (bottom - 1) / _cellSize; row++)
+	{
+		if ((_covered[row] & mask) != mask)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint64_t OcclusionGrid::columnMask(int firstColumn, int lastColumn)
+{
+	int count = lastColumn - firstColumn + 1;
+	uint64_t bits = count >= MAX_COLUMNS ? ~0ull : (1ull << count) - 1u;
+	return bits << firstColumn;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+
+/// <summary>
+/// A coarse coverage mask over the view of a camera, marking the cells fully covered by opaque draws.
+/// Each row of cells is a 64 bit mask, so testing a rect costs one comparison per row.
+/// </summary>
+class OcclusionGrid
+{
+public:
+	static constexpr int MAX_COLUMNS = 64;
+	static constexpr int MIN_CELL_SIZE = 16;
+
+	/// <summary>
+	/// Clears the mask and fits the cells to a view.
+	/// </summary>
+	/// <param name="view">The view of the camera in world coordinates</param>
+	void reset(const SDL_Rect& view);
+
+	/// <summary>
+	/// Marks the cells that lie completely inside an opaque rect as covered.
+	/// </summary>
+	/// <param name="opaqueRect">The opaque rect in world coordinates</param>
+	void cover(const SDL_Rect& opaqueRect);
+
+	/// <summary>
+	/// Checks whether every cell a rect touches inside the view is covered.
+	/// </summary>
+	/// <param name="rect">The rect in world coordinates</param>
+	/// <returns>True if nothing of it can be seen, false if part of it may be</returns>
+	bool isHidden(const SDL_Rect& rect) const;
+
+private:
+	SDL_Rect _view = { 0, 0, 0, 0 };
+	int _cellSize = MIN_CELL_SIZE;
+	int _columns = 0;
+	int _rows = 0;
+	std::vector<uint64_t> _covered;
+
+	static uint64_t columnMask(int firstColumn, int lastColumn);
+};
@@ -0,0 +1,160 @@
+#include "RenderQueue.h"
+
+#include "../Profiling/Profiler.h"
+
+RenderQueue::RenderQueue()
+{
+	_textureIDs.reserve(256);
+
+	// Fills have no texture, give them an ID of their own so they don't share a run with the first texture
+	_textureIDs.emplace(nullptr, 0u);
+}
+
+void RenderQueue::clear()
+{
+	_commands.clear();
+	_keys.clear();
+
+	// IDs only group draws, so once they run out they start over, but only between frames so the order inside a queue never changes
+	if (_textureIDs.size() >= MAX_TEXTURE_IDS)
+	{
+		_textureIDs.clear();
+		_textureIDs.emplace(nullptr, 0u);
+		_lastTexture = nullptr;
+		_lastTextureID = 0u;
+	}
+}
+
+void RenderQueue::submit(const DrawCommand& command, RenderLayer layer, int depth)
+{
+	uint64_t order = _commands.size();
+	if (order > ORDER_MASK)
+	{
+		return;
+	}
+
+	// Bias the depth so negative depths sort before positive ones as unsigned values
+	// Bias the depth so negative depths sort before positive ones as unsigned values. It is clamped first, so depths
+	// like SDL_MAX_SINT32 for overlays stay in front instead of overflowing
+	int biasedDepth = SDL_max(-DEPTH_BIAS, SDL_min(depth, DEPTH_BIAS - 1)) + DEPTH_BIAS;
+
+	uint64_t key = (static_cast<uint64_t>(layer) << LAYER_SHIFT)
+		| (static_cast<uint64_t>(biasedDepth) << DEPTH_SHIFT)
+		| (static_cast<uint64_t>(textureID(command.texture)) << TEXTURE_SHIFT)
+		| order;
+
+	_keys.emplace_back(key);
+	_commands.emplace_back(command);
+}
+
+void RenderQueue::sort()
+{
+	PROFILE_FUNCTION();
+
+	std::size_t count = _keys.size();
+	if (count < 2u)
+	{
+		return;
+	}
+
+	_keysScratch.resize(count);
+
+	// LSD radix sort on bytes. Keys are submitted in order and the sort is stable,
+	// so the submission order bits are already sorted and don't need a pass
+	constexpr int PASSES = (64 - ORDER_BITS + 7) / 8;
+
+	// All histograms are built in a single pass over the keys
+	uint32_t histograms[PASSES][256] = {};
+	for (uint64_t key : _keys)
+	{
+		for (int pass = 0; pass < PASSES; pass++)
+		{
+			histograms[pass][(key >> (ORDER_BITS + pass * 8)) & 0xFF]++;
+		}
+	}
+
+	uint64_t* keysIn = _keys.data();
+	uint64_t* keysOut = _keysScratch.data();
+	bool inScratch = false;
+
+	for (int pass = 0; pass < PASSES; pass++)
+	{
+		uint32_t* histogram = histograms[pass];
+		int shift = ORDER_BITS + pass * 8;
+
+		// Skip the pass when every key has the same value in this byte, which is the common case for layer and depth
+		if (histogram[(keysIn[0] >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		uint32_t offset = 0u;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			uint32_t digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			uint64_t key = keysIn[i];
+			keysOut[histogram[(key >> shift) & 0xFF]++] = key;
+		}
+
+		std::swap(keysIn, keysOut);
+		inScratch = !inScratch;
+	}
+
+	if (inScratch)
+	{
+		_keys.swap(_keysScratch);
+	}
+}
+
+void RenderQueue::append(const RenderQueue& sorted, const uint8_t* skip)
+{
+	std::size_t count = sorted.size();
+	if (_commands.size() + count > ORDER_MASK + 1u)
+	{
+		return;
+	}
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		if (skip != nullptr && skip[i] != 0u)
+		{
+			continue;
+		}
+
+		// The order bits become the index of the copy
+		_keys.emplace_back((sorted.keyAt(i) & ~ORDER_MASK) | _commands.size());
+		_commands.emplace_back(sorted[i]);
+	}
+}
+
+uint32_t RenderQueue::textureID(SDL_Texture* texture)
+{
+	// Consecutive submissions often share a texture, skip the lookup for those
+	if (texture == _lastTexture)
+	{
+		return _lastTextureID;
+	}
+
+	auto it = _textureIDs.find(texture);
+	if (it == _textureIDs.end())
+	{
+		if (_textureIDs.size() >= MAX_TEXTURE_IDS)
+		{
+			// Out of IDs until the next clear, the remaining textures share the last one and only lose some batching
+			return MAX_TEXTURE_IDS - 1u;
+		}
+
+		it = _textureIDs.emplace(texture, static_cast<uint32_t>(_textureIDs.size())).first;
+	}
+
+	_lastTexture = texture;
+	_lastTextureID = it->second;
+
+	return _lastTextureID;
+}
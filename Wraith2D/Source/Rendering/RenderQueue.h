@@ -0,0 +1,155 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "../RenderLayer.h"
+
+struct DrawCommand
+{
+	// Without a texture, the command is a solid fill of the dst rect in its color
+	SDL_Texture* texture = nullptr;
+	SDL_Rect srcRect = { 0, 0, 0, 0 };
+	SDL_Rect dstRect = { 0, 0, 0, 0 };
+	double angle = 0.0;
+	SDL_RendererFlip flip = SDL_FLIP_NONE;
+
+	// Applied as the texture color and alpha mod
+	SDL_Color color = { 255, 255, 255, 255 };
+
+	// Text draws the whole texture, so it has no source rectangle
+	bool hasSrcRect = false;
+
+	// The part of the dst rect this draw fully covers, empty when it may show what is behind it
+	SDL_Rect opaqueRect = { 0, 0, 0, 0 };
+};
+
+/// <summary>
+/// A part of a renderable drawn as several quads, like a glyph of text drawn from a glyph atlas.
+/// </summary>
+struct TexturedQuad
+{
+	// Without a texture, the quad is a solid fill in its color
+	SDL_Texture* texture = nullptr;
+	SDL_Rect srcRect = { 0, 0, 0, 0 };
+
+	// Relative to the dst rect of the renderable
+	SDL_Rect dstRect = { 0, 0, 0, 0 };
+
+	SDL_Color color = { 255, 255, 255, 255 };
+};
+
+class RenderQueue
+{
+public:
+	RenderQueue();
+
+	/// <summary>
+	/// Removes all commands, keeping the allocated memory for the next frame.
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Adds a draw command to the queue.
+	/// </summary>
+	/// <param name="command">The draw command</param>
+	/// <param name="layer">The render layer it belongs to</param>
+	/// <param name="depth">Its depth inside the layer</param>
+	void submit(const DrawCommand& command, RenderLayer layer, int depth);
+
+	/// <summary>
+	/// Sorts the commands by layer, then depth, then texture, then submission order.
+	/// </summary>
+	void sort();
+
+	/// <summary>
+	/// Appends the commands of another queue in its sorted order, keeping their layer, depth and texture keys.
+	/// The queue is drawn in append order, so don't sort it afterwards.
+	/// </summary>
+	/// <param name="sorted">A sorted queue</param>
+	/// <param name="skip">Optional flags in sorted order, commands flagged non-zero are left out</param>
+	void append(const RenderQueue& sorted, const uint8_t* skip = nullptr);
+
+	/// <summary>
+	/// Returns the number of commands in the queue.
+	/// </summary>
+	/// <returns>The number of commands</returns>
+	inline std::size_t size() const { return _commands.size(); }
+
+	/// <summary>
+	/// Returns a command in sorted order. Only valid after sort().
+	/// </summary>
+	/// <param name="index">The position in the sorted order</param>
+	/// <returns>The draw command</returns>
+	inline const DrawCommand& operator[](std::size_t index) const { return _commands[_keys[index] & ORDER_MASK]; }
+
+	/// <summary>
+	/// Returns the sort key of a command in sorted order. Only valid after sort().
+	/// </summary>
+	/// <param name="index">The position in the sorted order</param>
+	/// <returns>The sort key</returns>
+	inline uint64_t keyAt(std::size_t index) const { return _keys[index]; }
+
+	/// <summary>
+	/// Extracts the layer from a sort key.
+	/// </summary>
+	/// <param name="key">The sort key</param>
+	/// <returns>The render layer</returns>
+	static RenderLayer layerOf(uint64_t key) { return static_cast<RenderLayer>(key >> LAYER_SHIFT); }
+
+	/// <summary>
+	/// Extracts the depth from a sort key.
+	/// </summary>
+	/// <param name="key">The sort key</param>
+	/// <returns>The depth, clamped to the range the key can hold</returns>
+	static int depthOf(uint64_t key) { return static_cast<int>((key >> DEPTH_SHIFT) & DEPTH_MASK) - DEPTH_BIAS; }
+
+	/// <summary>
+	/// Returns the layer and depth part of a sort key, which is equal for commands in the same layer and depth.
+	/// </summary>
+	/// <param name="key">The sort key</param>
+	/// <returns>The layer and depth part of the key</returns>
+	static uint64_t depthRangeOf(uint64_t key) { return key >> DEPTH_SHIFT; }
+
+	/// <summary>
+	/// Returns the depth of the command at a position in a strict order, so no two positions share a depth range.
+	/// Positions past the number of depths a key can hold share the last one.
+	/// </summary>
+	/// <param name="rank">The position in the order</param>
+	/// <returns>The depth to submit the command at</returns>
+	static int depthOfRank(std::size_t rank) { return static_cast<int>(SDL_min(rank, static_cast<std::size_t>(DEPTH_MASK))) - DEPTH_BIAS; }
+
+private:
+	/**
+	* Sort key layout, from the most significant bit:
+	* [ layer : 6 ][ depth : 20 ][ texture : 12 ][ submission order : 26 ]
+	* The submission order doubles as the index of the command.
+	*/
+	static constexpr int ORDER_BITS = 26;
+	static constexpr int TEXTURE_BITS = 12;
+	static constexpr int DEPTH_BITS = 20;
+
+	static constexpr int TEXTURE_SHIFT = ORDER_BITS;
+	static constexpr int DEPTH_SHIFT = TEXTURE_SHIFT + TEXTURE_BITS;
+	static constexpr int LAYER_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+
+	static constexpr uint64_t ORDER_MASK = (1ull << ORDER_BITS) - 1u;
+	static constexpr uint64_t DEPTH_MASK = (1ull << DEPTH_BITS) - 1u;
+	static constexpr int DEPTH_BIAS = 1 << (DEPTH_BITS - 1);
+	static constexpr uint32_t MAX_TEXTURE_IDS = 1u << TEXTURE_BITS;
+
+	std::vector<DrawCommand> _commands;
+
+	// Keys are sorted ping-ponging with the scratch buffer
+	std::vector<uint64_t> _keys;
+	std::vector<uint64_t> _keysScratch;
+
+	// Small IDs for the textures, so they fit in the key
+	std::unordered_map<SDL_Texture*, uint32_t> _textureIDs;
+	SDL_Texture* _lastTexture = nullptr;
+	uint32_t _lastTextureID = 0u;
+
+	uint32_t textureID(SDL_Texture* texture);
+};
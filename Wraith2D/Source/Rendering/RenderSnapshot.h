@@ -0,0 +1,88 @@
+#pragma once
+
+#include <SDL.h>
+#include <vector>
+
+#include "RenderQueue.h"
+#include "SpriteBatcher.h"
+#include "DebugDraw.h"
+
+/// <summary>
+/// The draw data of a frame, copied out of the world so it can be drawn while the next frame is simulated.
+/// Holds no pointers to components, only textures and rects.
+/// </summary>
+struct RenderSnapshot
+{
+	// What a camera sees, drawn into its viewport
+	struct View
+	{
+		SDL_Rect viewport = { 0, 0, 0, 0 };
+		SDL_Point origin = { 0, 0 };
+		float zoom = 1.f;
+
+		// Every layer in draw order, each already sorted
+		RenderQueue queue;
+	};
+
+	// A static layer tile to re-render before the views are drawn
+	struct CacheTile
+	{
+		SDL_Texture* target = nullptr;
+		SDL_Point origin = { 0, 0 };
+		RenderQueue queue;
+	};
+
+	// Views and tiles are reused across frames so their queues keep their memory
+	std::vector<View> views;
+	std::size_t viewCount = 0u;
+
+	std::vector<CacheTile> cacheTiles;
+	std::size_t cacheTileCount = 0u;
+
+	// The views are drawn at this scale of the output resolution, then stretched to it
+	float resolutionScale = 1.f;
+
+	SDL_Texture* cursorTexture = nullptr;
+	SDL_Rect cursorSrcRect = { 0, 0, 0, 0 };
+	SDL_Rect cursorDstRect = { 0, 0, 0, 0 };
+
+#ifdef WRAITH2D_DEBUG_DRAW_ENABLED
+	// Drawn over every view, after the world
+	DebugDrawList debugDraw;
+#endif
+
+	// Filled in when the snapshot is drawn
+	DrawStats stats;
+
+	void clear()
+	{
+		viewCount = 0u;
+		cacheTileCount = 0u;
+		cursorTexture = nullptr;
+		stats = DrawStats();
+	}
+
+	View& addView()
+	{
+		if (viewCount == views.size())
+		{
+			views.emplace_back();
+		}
+
+		View& view = views[viewCount++];
+		view.queue.clear();
+		return view;
+	}
+
+	CacheTile& addCacheTile()
+	{
+		if (cacheTileCount == cacheTiles.size())
+		{
+			cacheTiles.emplace_back();
+		}
+
+		CacheTile& tile = cacheTiles[cacheTileCount++];
+		tile.queue.clear();
+		return tile;
+	}
+};
@@ -0,0 +1,141 @@
+#include "SpatialGrid.h"
+
+SpatialGrid::SpatialGrid(int cellSize)
+	: _cellSize(SDL_max(cellSize, 1))
+{
+	_cells.resize(1u);
+}
+
+void SpatialGrid::resize(int worldWidth, int worldHeight, int cellSize)
+{
+	_cellSize = SDL_max(cellSize, 1);
+	_columns = SDL_max((worldWidth + _cellSize - 1) / _cellSize, 1);
+	_rows = SDL_max((worldHeight + _cellSize - 1) / _cellSize, 1);
+
+	_cells.clear();
+	_cells.resize(static_cast<std::size_t>(_columns) * _rows);
+
+	for (uint32_t handle = 0; handle < _items.size(); handle++)
+	{
+		Item& item = _items[handle];
+		if (item.renderable != nullptr)
+		{
+			item.cells = cellRange(item.bounds);
+			addToCells(handle, item.cells);
+		}
+	}
+}
+
+uint32_t SpatialGrid::insert(Renderable* renderable, const SDL_Rect& bounds)
+{
+	uint32_t handle;
+	if (!_freeHandles.empty())
+	{
+		handle = _freeHandles.back();
+		_freeHandles.pop_back();
+	}
+	else
+	{
+		handle = static_cast<uint32_t>(_items.size());
+		_items.emplace_back();
+	}
+
+	Item& item = _items[handle];
+	item.renderable = renderable;
+	item.bounds = bounds;
+	item.cells = cellRange(bounds);
+	item.queryStamp = 0u;
+
+	addToCells(handle, item.cells);
+
+	return handle;
+}
+
+void SpatialGrid::update(uint32_t handle, const SDL_Rect& bounds)
+{
+	Item& item = _items[handle];
+	item.bounds = bounds;
+
+	// Most frames an item stays inside the same cells, so only the bounds change
+	CellRange range = cellRange(bounds);
+	if (range == item.cells)
+	{
+		return;
+	}
+
+	removeFromCells(handle, item.cells);
+	addToCells(handle, range);
+	item.cells = range;
+}
+
+void SpatialGrid::remove(uint32_t handle)
+{
+	Item& item = _items[handle];
+	removeFromCells(handle, item.cells);
+
+	item.renderable = nullptr;
+	_freeHandles.emplace_back(handle);
+}
+
+SpatialGrid::CellRange SpatialGrid::cellRange(const SDL_Rect& bounds) const
+{
+	CellRange range;
+
+	// Floor division, so negative coordinates land in the cell before zero and get clamped to the border
+	auto cellOf = [this](int coordinate) { return coordinate >= 0 ? coordinate / _cellSize : (coordinate + 1) / _cellSize - 1; };
+
+	range.minX = SDL_max(0, SDL_min(cellOf(bounds.x), _columns - 1));
+	range.minY = SDL_max(0, SDL_min(cellOf(bounds.y), _rows - 1));
+	range.maxX = SDL_max(0, SDL_min(cellOf(bounds.x + SDL_max(bounds.w, 1) - 1), _columns - 1));
+	range.maxY = SDL_max(0, SDL_min(cellOf(bounds.y + SDL_max(bounds.h, 1) - 1), _rows - 1));
+
+	return range;
+}
+
+void SpatialGrid::addToCells(uint32_t handle, const CellRange& range)
+{
+	for (int row = range.minY; row <= range.maxY; row++)
+	{
+		for (int column = range.minX; column <= range.maxX; column++)
+		{
+			_cells[row * _columns + column].emplace_back(handle);
+		}
+	}
+}
+
+void SpatialGrid::removeFromCells(uint32_t handle, const CellRange& range)
+{
+	for (int row = range.minY; row <= range.maxY; row++)
+	{
+		for (int column = range.minX; column <= range.maxX; column++)
+		{
+			// Cells are small, so a linear search and swap with the last handle is enough
+			std::vector<uint32_t>& cell = _cells[row * _columns + column];
+			for (std::size_t i = 0; i < cell.size(); i++)
+			{
+				if (cell[i] == handle)
+				{
+					cell[i] = cell.back();
+					cell.pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
+
+uint32_t SpatialGrid::nextQueryStamp()
+{
+	if (++_queryStamp == 0u)
+	{
+		// The stamp wrapped around, clear the old stamps so none of them matches by accident
+		for (auto& item : _items)
+		{
+			item.queryStamp = 0u;
+		}
+
+		_queryStamp = 1u;
+	}
+
+	return _queryStamp;
+}
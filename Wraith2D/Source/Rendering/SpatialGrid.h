@@ -0,0 +1,128 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+
+class Renderable;
+
+class SpatialGrid
+{
+public:
+	static constexpr uint32_t INVALID_HANDLE = UINT32_MAX;
+
+	/// <summary>
+	/// Creates a spatial grid.
+	/// </summary>
+	/// <param name="cellSize">The width and height of each cell in world units</param>
+	SpatialGrid(int cellSize = 256);
+
+	/// <summary>
+	/// Resizes the grid to cover the game world and re-inserts every item.
+	/// Items outside the world are kept in the border cells.
+	/// </summary>
+	/// <param name="worldWidth">The width of the game world</param>
+	/// <param name="worldHeight">The height of the game world</param>
+	/// <param name="cellSize">The width and height of each cell in world units</param>
+	void resize(int worldWidth, int worldHeight, int cellSize);
+
+	/// <summary>
+	/// Adds a renderable to the grid.
+	/// </summary>
+	/// <param name="renderable">The renderable</param>
+	/// <param name="bounds">Its bounds in world coordinates</param>
+	/// <returns>The handle used to update and remove it</returns>
+	uint32_t insert(Renderable* renderable, const SDL_Rect& bounds);
+
+	/// <summary>
+	/// Updates the bounds of a renderable. Only touches the cells when it moves to a different set of them.
+	/// </summary>
+	/// <param name="handle">The handle returned by insert()</param>
+	/// <param name="bounds">The new bounds in world coordinates</param>
+	void update(uint32_t handle, const SDL_Rect& bounds);
+
+	/// <summary>
+	/// Removes a renderable from the grid.
+	/// </summary>
+	/// <param name="handle">The handle returned by insert()</param>
+	void remove(uint32_t handle);
+
+	/// <summary>
+	/// Collects the renderables whose bounds intersect an area, each one only once.
+	/// </summary>
+	/// <typeparam name="Container">A vector-like container of Renderable pointers</typeparam>
+	/// <param name="area">The area in world coordinates</param>
+	/// <param name="result">The container the renderables are appended to</param>
+	template<typename Container>
+	void query(const SDL_Rect& area, Container& result)
+	{
+		CellRange range = cellRange(area);
+		uint32_t stamp = nextQueryStamp();
+
+		for (int row = range.minY; row <= range.maxY; row++)
+		{
+			for (int column = range.minX; column <= range.maxX; column++)
+			{
+				for (uint32_t handle : _cells[row * _columns + column])
+				{
+					Item& item = _items[handle];
+
+					// Items spanning several cells are found once per cell
+					if (item.queryStamp == stamp)
+					{
+						continue;
+					}
+
+					item.queryStamp = stamp;
+
+					if (SDL_HasIntersection(&item.bounds, &area))
+					{
+						result.emplace_back(item.renderable);
+					}
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Returns the number of renderables in the grid.
+	/// </summary>
+	/// <returns>The number of renderables</returns>
+	inline std::size_t size() const { return _items.size() - _freeHandles.size(); }
+
+private:
+	struct CellRange
+	{
+		int minX = 0;
+		int minY = 0;
+		int maxX = 0;
+		int maxY = 0;
+
+		bool operator==(const CellRange& other) const
+		{
+			return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+		}
+	};
+
+	struct Item
+	{
+		Renderable* renderable = nullptr;
+		SDL_Rect bounds = { 0, 0, 0, 0 };
+		CellRange cells;
+		uint32_t queryStamp = 0u;
+	};
+
+	int _cellSize;
+	int _columns = 1;
+	int _rows = 1;
+
+	std::vector<std::vector<uint32_t>> _cells;
+	std::vector<Item> _items;
+	std::vector<uint32_t> _freeHandles;
+	uint32_t _queryStamp = 0u;
+
+	CellRange cellRange(const SDL_Rect& bounds) const;
+	void addToCells(uint32_t handle, const CellRange& range);
+	void removeFromCells(uint32_t handle, const CellRange& range);
+	uint32_t nextQueryStamp();
+};
@@ -0,0 +1,201 @@
+#include "SpriteBatcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "../Profiling/Profiler.h"
+
+void SpriteBatcher::draw(SDL_Renderer* renderer, const RenderQueue& queue, const SDL_Point& origin, float zoom)
+{
+	PROFILE_FUNCTION();
+
+	_origin = origin;
+	_zoom = zoom;
+
+	_stats = DrawStats();
+	_stats.commands = static_cast<uint32_t>(queue.size());
+	_currentTexture = nullptr;
+
+	std::size_t rangeBegin = 0u;
+	while (rangeBegin < queue.size())
+	{
+		// Commands in the same layer and depth are already grouped by texture by the sort
+		uint64_t range = RenderQueue::depthRangeOf(queue.keyAt(rangeBegin));
+		std::size_t rangeEnd = rangeBegin + 1u;
+		while (rangeEnd < queue.size() && RenderQueue::depthRangeOf(queue.keyAt(rangeEnd)) == range)
+		{
+			rangeEnd++;
+		}
+
+		// Texture IDs don't follow the previous range, so draw the run of the bound texture first to save a switch
+		std::size_t boundBegin = rangeEnd;
+		std::size_t boundEnd = rangeEnd;
+		if (_currentTexture != nullptr && queue[rangeBegin].texture != _currentTexture)
+		{
+			for (std::size_t i = rangeBegin + 1u; i < rangeEnd; i++)
+			{
+				if (queue[i].texture == _currentTexture)
+				{
+					boundBegin = i;
+					boundEnd = i + 1u;
+					while (boundEnd < rangeEnd && queue[boundEnd].texture == _currentTexture)
+					{
+						boundEnd++;
+					}
+					break;
+				}
+			}
+		}
+
+		if (boundBegin < rangeEnd)
+		{
+			drawRun(renderer, queue, boundBegin, boundEnd);
+			drawRun(renderer, queue, rangeBegin, boundBegin);
+			drawRun(renderer, queue, boundEnd, rangeEnd);
+		}
+		else
+		{
+			drawRun(renderer, queue, rangeBegin, rangeEnd);
+		}
+
+		rangeBegin = rangeEnd;
+	}
+}
+
+void SpriteBatcher::drawRun(SDL_Renderer* renderer, const RenderQueue& queue, std::size_t begin, std::size_t end)
+{
+	// Only the texture sort groups a range by texture, so split it wherever the texture changes.
+	// Fills are batched by color only inside the parts without a texture
+	std::size_t textureBegin = begin;
+	while (textureBegin < end)
+	{
+		SDL_Texture* texture = queue[textureBegin].texture;
+		std::size_t textureEnd = textureBegin + 1u;
+		while (textureEnd < end && queue[textureEnd].texture == texture)
+		{
+			textureEnd++;
+		}
+
+		if (texture == nullptr)
+		{
+			drawFills(renderer, queue, textureBegin, textureEnd);
+		}
+		else
+		{
+			for (std::size_t i = textureBegin; i < textureEnd; i++)
+			{
+				drawCommand(renderer, queue[i]);
+			}
+		}
+
+		textureBegin = textureEnd;
+	}
+}
+
+void SpriteBatcher::drawFills(SDL_Renderer* renderer, const RenderQueue& queue, std::size_t begin, std::size_t end)
+{
+	_fills.clear();
+	for (std::size_t i = begin; i < end; i++)
+	{
+		const DrawCommand& command = queue[i];
+		SDL_Rect rect = toScreen(command.dstRect);
+		if (rect.w <= 0 || rect.h <= 0)
+		{
+			continue;
+		}
+
+		uint32_t color = (static_cast<uint32_t>(command.color.r) << 24) | (static_cast<uint32_t>(command.color.g) << 16)
+			| (static_cast<uint32_t>(command.color.b) << 8) | command.color.a;
+		_fills.push_back(Fill{ color, rect });
+	}
+
+	// The run is in a single layer and depth, so the fills can be reordered by color
+	std::sort(_fills.begin(), _fills.end(), [](const Fill& a, const Fill& b) { return a.color < b.color; });
+
+	std::size_t colorBegin = 0u;
+	while (colorBegin < _fills.size())
+	{
+		uint32_t color = _fills[colorBegin].color;
+
+		_fillRects.clear();
+		std::size_t colorEnd = colorBegin;
+		while (colorEnd < _fills.size() && _fills[colorEnd].color == color)
+		{
+			_fillRects.push_back(_fills[colorEnd].rect);
+			colorEnd++;
+		}
+
+		Uint8 alpha = static_cast<Uint8>(color & 0xFF);
+		SDL_SetRenderDrawBlendMode(renderer, alpha == 255 ? SDL_BLENDMODE_NONE : SDL_BLENDMODE_BLEND);
+		SDL_SetRenderDrawColor(renderer, static_cast<Uint8>(color >> 24), static_cast<Uint8>(color >> 16), static_cast<Uint8>(color >> 8), alpha);
+		SDL_RenderFillRects(renderer, _fillRects.data(), static_cast<int>(_fillRects.size()));
+
+		_stats.drawCalls++;
+		_stats.batches++;
+
+		colorBegin = colorEnd;
+	}
+
+	// Leave the draw state as the rest of the renderer expects it
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+void SpriteBatcher::drawCommand(SDL_Renderer* renderer, const DrawCommand& command)
+{
+	const SDL_Rect* srcRect = command.hasSrcRect ? &command.srcRect : nullptr;
+	SDL_Rect dstRect = toScreen(command.dstRect);
+
+	// SDL_RenderCopyEx goes through a slower path even without rotation or flip
+	bool isEx = command.angle != 0.0 || command.flip != SDL_FLIP_NONE;
+
+	bool colorChanged = command.color.r != _currentColor.r || command.color.g != _currentColor.g
+		|| command.color.b != _currentColor.b || command.color.a != _currentColor.a;
+
+	if (command.texture != _currentTexture)
+	{
+		_stats.textureSwitches++;
+		_stats.batches++;
+	}
+	else if (isEx != _currentIsEx)
+	{
+		_stats.batches++;
+	}
+
+	// The mod is texture state, so it is set again whenever another texture was used in between
+	if (command.texture != _currentTexture || colorChanged)
+	{
+		SDL_SetTextureColorMod(command.texture, command.color.r, command.color.g, command.color.b);
+		SDL_SetTextureAlphaMod(command.texture, command.color.a);
+		_currentColor = command.color;
+	}
+
+	_currentTexture = command.texture;
+	_currentIsEx = isEx;
+
+	if (isEx)
+	{
+		SDL_RenderCopyEx(renderer, command.texture, srcRect, &dstRect, command.angle, nullptr, command.flip);
+	}
+	else
+	{
+		SDL_RenderCopy(renderer, command.texture, srcRect, &dstRect);
+	}
+
+	_stats.drawCalls++;
+}
+
+SDL_Rect SpriteBatcher::toScreen(const SDL_Rect& worldRect) const
+{
+	if (_zoom == 1.f)
+	{
+		return SDL_Rect{ worldRect.x - _origin.x, worldRect.y - _origin.y, worldRect.w, worldRect.h };
+	}
+
+	// Both edges are rounded, so neighbouring rects still meet without gaps when zoomed
+	int left = static_cast<int>(std::round((worldRect.x - _origin.x) * _zoom));
+	int top = static_cast<int>(std::round((worldRect.y - _origin.y) * _zoom));
+	int right = static_cast<int>(std::round((worldRect.x + worldRect.w - _origin.x) * _zoom));
+	int bottom = static_cast<int>(std::round((worldRect.y + worldRect.h - _origin.y) * _zoom));
+
+	return SDL_Rect{ left, top, right - left, bottom - top };
+}
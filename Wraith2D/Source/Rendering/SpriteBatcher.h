@@ -0,0 +1,75 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <vector>
+
+#include "RenderQueue.h"
+
+struct DrawStats
+{
+	// Commands in the queue
+	uint32_t commands = 0u;
+
+	// SDL_RenderCopy, SDL_RenderCopyEx and SDL_RenderFillRects calls issued
+	uint32_t drawCalls = 0u;
+
+	// Times the bound texture changed between consecutive draws
+	uint32_t textureSwitches = 0u;
+
+	// Runs of consecutive draws that share a texture and draw call, which SDL can batch together
+	uint32_t batches = 0u;
+
+	// Commands skipped because opaque draws in front hid them, and the screen pixels they would have filled
+	uint32_t occludedCommands = 0u;
+	uint64_t occludedPixels = 0u;
+};
+
+class SpriteBatcher
+{
+public:
+	/// <summary>
+	/// Draws a sorted render queue, keeping texture switches to a minimum.
+	/// Commands with the same layer and depth may be drawn in any order, so inside those ranges
+	/// draws are grouped by texture, starting with the texture that is already bound.
+	/// Commands without a texture are solid fills, drawn with one SDL_RenderFillRects call per color inside those ranges.
+	/// Commands are in world coordinates and converted to the screen here, right before each draw.
+	/// </summary>
+	/// <param name="renderer">The SDL Renderer</param>
+	/// <param name="queue">The sorted render queue</param>
+	/// <param name="origin">The world position drawn at the top left corner of the viewport</param>
+	/// <param name="zoom">The scale the world is drawn at</param>
+	void draw(SDL_Renderer* renderer, const RenderQueue& queue, const SDL_Point& origin = { 0, 0 }, float zoom = 1.f);
+
+	/// <summary>
+	/// Returns the statistics of the last drawn queue.
+	/// </summary>
+	/// <returns>The draw statistics</returns>
+	inline const DrawStats& stats() const { return _stats; }
+
+private:
+	// A solid fill in screen coordinates, with its color packed so fills sort by it
+	struct Fill
+	{
+		uint32_t color;
+		SDL_Rect rect;
+	};
+
+	DrawStats _stats;
+
+	SDL_Texture* _currentTexture = nullptr;
+	SDL_Color _currentColor = { 255, 255, 255, 255 };
+	bool _currentIsEx = false;
+
+	SDL_Point _origin = { 0, 0 };
+	float _zoom = 1.f;
+
+	// Reused across draws so fills don't allocate every frame
+	std::vector<Fill> _fills;
+	std::vector<SDL_Rect> _fillRects;
+
+	void drawRun(SDL_Renderer* renderer, const RenderQueue& queue, std::size_t begin, std::size_t end);
+	void drawFills(SDL_Renderer* renderer, const RenderQueue& queue, std::size_t begin, std::size_t end);
+	void drawCommand(SDL_Renderer* renderer, const DrawCommand& command);
+	SDL_Rect toScreen(const SDL_Rect& worldRect) const;
+};
@@ -0,0 +1,141 @@
+#include "TextTextureCache.h"
+
+#include <SDL_ttf.h>
+#include <iostream>
+
+#include "../AssetManager.h"
+#include "../Engine.h"
+
+std::size_t TextTextureCache::KeyHash::operator()(const Key& key) const
+{
+	std::size_t hash = std::hash<std::string>()(key.text);
+	hash ^= std::hash<std::string>()(key.fontID) + 0x9E3779B9u + (hash << 6) + (hash >> 2);
+	hash ^= key.wrapLength;
+	return hash;
+}
+
+TextTextureCache::TextTextureCache(std::size_t budget)
+	: _budget(budget)
+{
+}
+
+TextTextureCache::~TextTextureCache()
+{
+	clear();
+}
+
+SDL_Texture* TextTextureCache::acquire(const std::string& fontID, const std::string& text, unsigned int wrapLength, int& width, int& height)
+{
+	Key key{ fontID, text, wrapLength };
+
+	auto cached = _entries.find(key);
+	if (cached != _entries.end())
+	{
+		Entry& entry = cached->second;
+		if (entry.references++ == 0)
+		{
+			_lru.erase(entry.lruPosition);
+		}
+
+		width = entry.width;
+		height = entry.height;
+		_hits++;
+
+		return entry.texture;
+	}
+
+	_misses++;
+
+	SDL_Surface* surf = TTF_RenderText_Blended_Wrapped(AssetManager::instance().getFont(fontID), text.c_str(), SDL_Color{ 255, 255, 255, 255 }, wrapLength);
+	if (surf == nullptr)
+	{
+		std::cerr << "Failed to render text! Error: " << TTF_GetError() << std::endl;
+		width = 0;
+		height = 0;
+		return nullptr;
+	}
+
+	SDL_Texture* texture = nullptr;
+	{
+		auto rendererLock = Engine::instance().lockRenderer();
+		texture = SDL_CreateTextureFromSurface(Engine::instance().getRenderer(), surf);
+	}
+	SDL_FreeSurface(surf);
+
+	if (texture == nullptr)
+	{
+		std::cerr << "Failed to create text texture! Error: " << SDL_GetError() << std::endl;
+		width = 0;
+		height = 0;
+		return nullptr;
+	}
+
+	Entry entry;
+	entry.texture = texture;
+	SDL_QueryTexture(texture, nullptr, nullptr, &entry.width, &entry.height);
+	entry.bytes = static_cast<std::size_t>(entry.width) * entry.height * 4u;
+	entry.references = 1;
+
+	EntryNode* node = &*_entries.emplace(std::move(key), entry).first;
+	_entriesByTexture.emplace(texture, node);
+	_memoryUsed += entry.bytes;
+
+	width = entry.width;
+	height = entry.height;
+
+	evict();
+
+	return texture;
+}
+
+void TextTextureCache::release(SDL_Texture* texture)
+{
+	auto node = _entriesByTexture.find(texture);
+	if (node == _entriesByTexture.end())
+	{
+		return;
+	}
+
+	Entry& entry = node->second->second;
+	if (--entry.references == 0)
+	{
+		entry.lruPosition = _lru.insert(_lru.end(), texture);
+		evict();
+	}
+}
+
+void TextTextureCache::setBudget(std::size_t budget)
+{
+	_budget = budget;
+	evict();
+}
+
+void TextTextureCache::clear()
+{
+	for (auto& entry : _entries)
+	{
+		Engine::instance().destroyTexture(entry.second.texture);
+	}
+
+	_entries.clear();
+	_entriesByTexture.clear();
+	_lru.clear();
+	_memoryUsed = 0u;
+}
+
+void TextTextureCache::evict()
+{
+	// Referenced textures are in use, so the cache can stay over budget when there is nothing left to evict
+	while (_memoryUsed > _budget && !_lru.empty())
+	{
+		SDL_Texture* texture = _lru.front();
+		_lru.pop_front();
+
+		auto node = _entriesByTexture.find(texture);
+		_memoryUsed -= node->second->second.bytes;
+		_entries.erase(_entries.find(node->second->first));
+		_entriesByTexture.erase(node);
+
+		Engine::instance().destroyTexture(texture);
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <SDL.h>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+/// <summary>
+/// Shares rasterized text textures between Text components showing the same content.
+/// Text is rasterized in white and tinted when drawn, so texts that only differ in color share a texture too.
+/// Textures are reference counted. Once unreferenced they are kept for reuse,
+/// and the least recently used ones are destroyed when the cache goes over its memory budget.
+/// </summary>
+class TextTextureCache
+{
+public:
+	/// <summary>
+	/// Creates an empty cache.
+	/// </summary>
+	/// <param name="budget">The number of bytes of texture memory above which unreferenced textures are destroyed</param>
+	TextTextureCache(std::size_t budget = 16u * 1024u * 1024u);
+	~TextTextureCache();
+
+	TextTextureCache(const TextTextureCache&) = delete;
+	TextTextureCache& operator=(const TextTextureCache&) = delete;
+
+	/// <summary>
+	/// Returns the texture for a text, rasterizing it only if no other Text uses the same content.
+	/// Every acquired texture must be released once.
+	/// </summary>
+	/// <param name="fontID">The font ID</param>
+	/// <param name="text">The text</param>
+	/// <param name="wrapLength">The wrap length in pixels</param>
+	/// <param name="width">The width of the texture</param>
+	/// <param name="height">The height of the texture</param>
+	/// <returns>A pointer to the texture, or nullptr if it couldn't be created</returns>
+	SDL_Texture* acquire(const std::string& fontID, const std::string& text, unsigned int wrapLength, int& width, int& height);
+
+	/// <summary>
+	/// Releases a texture returned by acquire().
+	/// </summary>
+	/// <param name="texture">The texture</param>
+	void release(SDL_Texture* texture);
+
+	/// <summary>
+	/// Changes the memory budget, destroying unreferenced textures if the cache is over it.
+	/// </summary>
+	/// <param name="budget">The budget in bytes</param>
+	void setBudget(std::size_t budget);
+
+	/// <summary>
+	/// Destroys every texture, referenced or not.
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	/// Returns the texture memory used by the cache, an estimate at 4 bytes per pixel.
+	/// </summary>
+	/// <returns>The memory used in bytes</returns>
+	inline std::size_t memoryUsed() const { return _memoryUsed; }
+
+	/// <summary>
+	/// Returns the number of cached textures.
+	/// </summary>
+	/// <returns>The number of textures</returns>
+	inline std::size_t size() const { return _entries.size(); }
+
+	/// <summary>
+	/// Returns how many acquire() calls reused a cached texture.
+	/// </summary>
+	/// <returns>The number of hits</returns>
+	inline uint64_t hits() const { return _hits; }
+
+	/// <summary>
+	/// Returns how many acquire() calls had to rasterize the text.
+	/// </summary>
+	/// <returns>The number of misses</returns>
+	inline uint64_t misses() const { return _misses; }
+
+private:
+	struct Key
+	{
+		std::string fontID;
+		std::string text;
+		unsigned int wrapLength;
+
+		bool operator==(const Key& other) const
+		{
+			return wrapLength == other.wrapLength && text == other.text && fontID == other.fontID;
+		}
+	};
+
+	struct KeyHash
+	{
+		std::size_t operator()(const Key& key) const;
+	};
+
+	struct Entry
+	{
+		SDL_Texture* texture = nullptr;
+		int width = 0;
+		int height = 0;
+		std::size_t bytes = 0u;
+		int references = 0;
+
+		// Position in the LRU list while unreferenced
+		std::list<SDL_Texture*>::iterator lruPosition;
+	};
+
+	using EntryNode = std::pair<const Key, Entry>;
+
+	std::size_t _budget;
+	std::size_t _memoryUsed = 0u;
+	uint64_t _hits = 0u;
+	uint64_t _misses = 0u;
+
+	std::unordered_map<Key, Entry, KeyHash> _entries;
+
+	// Map nodes never move, so pointers to them stay valid through rehashes
+	std::unordered_map<SDL_Texture*, EntryNode*> _entriesByTexture;
+
+	// Unreferenced textures, least recently used first
+	std::list<SDL_Texture*> _lru;
+
+	void evict();
+};